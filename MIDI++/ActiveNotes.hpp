@@ -0,0 +1,136 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <vector>
+
+// Open note-ons per channel and key while the schedule is built, so note-offs can
+// be paired FIFO or LIFO. 16 x 128 slots, each a small ring of start times; a key
+// struck more than INLINE_STARTS times before its release spills to a deque.
+// Push and both pops are O(1); drain() only visits keys that are still open.
+class ActiveNoteTracker {
+public:
+    using Time = std::chrono::nanoseconds;
+    static constexpr uint32_t INLINE_STARTS = 4;
+
+    ActiveNoteTracker() : slots(16 * 128) { active.reserve(256); }
+
+    void push(int channel, int note, Time start) {
+        const uint16_t index = slotIndex(channel, note);
+        Slot& s = slots[index];
+        if (s.count == 0)
+            activate(index);
+        if (s.spill) {
+            s.spill->push_back(start);
+        }
+        else if (s.count < INLINE_STARTS) {
+            s.ring[(s.head + s.count) % INLINE_STARTS] = start;
+        }
+        else {
+            s.spill = std::make_unique<std::deque<Time>>();
+            for (uint32_t i = 0; i < s.count; ++i)
+                s.spill->push_back(s.ring[(s.head + i) % INLINE_STARTS]);
+            s.spill->push_back(start);
+        }
+        ++s.count;
+    }
+
+    // Removes the earliest start of this key; false if the key isn't open.
+    bool popOldest(int channel, int note, Time* start = nullptr) {
+        const uint16_t index = slotIndex(channel, note);
+        Slot& s = slots[index];
+        if (s.count == 0)
+            return false;
+        Time t;
+        if (s.spill) {
+            t = s.spill->front();
+            s.spill->pop_front();
+        }
+        else {
+            t = s.ring[s.head];
+            s.head = (s.head + 1) % INLINE_STARTS;
+        }
+        if (start)
+            *start = t;
+        release(index);
+        return true;
+    }
+
+    // Removes the latest start of this key; false if the key isn't open.
+    bool popNewest(int channel, int note, Time* start = nullptr) {
+        const uint16_t index = slotIndex(channel, note);
+        Slot& s = slots[index];
+        if (s.count == 0)
+            return false;
+        Time t;
+        if (s.spill) {
+            t = s.spill->back();
+            s.spill->pop_back();
+        }
+        else {
+            t = s.ring[(s.head + s.count - 1) % INLINE_STARTS];
+        }
+        if (start)
+            *start = t;
+        release(index);
+        return true;
+    }
+
+    [[nodiscard]] bool empty() const noexcept { return active.empty(); }
+    [[nodiscard]] uint32_t openCount(int channel, int note) const noexcept { return slots[slotIndex(channel, note)].count; }
+
+    // Calls fn(channel, note, start) for every open start, oldest first per key,
+    // and leaves the tracker empty.
+    template <typename Fn>
+    void drain(Fn&& fn) {
+        for (uint16_t index : active) {
+            Slot& s = slots[index];
+            const int channel = index >> 7;
+            const int note = index & 0x7F;
+            for (uint32_t i = 0; i < s.count; ++i)
+                fn(channel, note, s.spill ? (*s.spill)[i] : s.ring[(s.head + i) % INLINE_STARTS]);
+            s = Slot{};
+        }
+        active.clear();
+    }
+
+    void clear() {
+        drain([](int, int, Time) {});
+    }
+
+private:
+    struct Slot {
+        std::array<Time, INLINE_STARTS> ring{};
+        std::unique_ptr<std::deque<Time>> spill;   // holds every start while set
+        uint32_t count = 0;
+        uint16_t head = 0;
+        uint16_t activePos = 0;                    // index into `active` while count > 0
+    };
+
+    static uint16_t slotIndex(int channel, int note) noexcept {
+        return static_cast<uint16_t>(((channel & 0x0F) << 7) | (note & 0x7F));
+    }
+
+    void activate(uint16_t index) {
+        slots[index].activePos = static_cast<uint16_t>(active.size());
+        active.push_back(index);
+    }
+
+    // Drops one start from the count; retires the slot once nothing is open.
+    void release(uint16_t index) {
+        Slot& s = slots[index];
+        if (--s.count > 0)
+            return;
+        s.spill.reset();
+        s.head = 0;
+        const uint16_t moved = active.back();
+        active[s.activePos] = moved;
+        slots[moved].activePos = s.activePos;
+        active.pop_back();
+    }
+
+    std::vector<Slot> slots;
+    std::vector<uint16_t> active;   // slots with count > 0, in no particular order
+};
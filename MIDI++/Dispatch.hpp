@@ -0,0 +1,129 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// How play_notes hands a batch of due events to SendInput. INLINE runs the batch
+// on the playback thread itself; INJECTOR queues it through a lock-free ring to
+// one pinned thread that does nothing but inject; POOL is the old round trip
+// through the processing pool, kept for comparison.
+namespace dispatch {
+
+    enum class Mode {
+        Inline,
+        Injector,
+        Pool
+    };
+
+    // "INLINE", "INJECTOR" or "POOL"; false for anything else.
+    [[nodiscard]] inline bool modeFromName(std::string_view name, Mode& mode) noexcept {
+        if (name == "INLINE")
+            mode = Mode::Inline;
+        else if (name == "INJECTOR")
+            mode = Mode::Injector;
+        else if (name == "POOL")
+            mode = Mode::Pool;
+        else
+            return false;
+        return true;
+    }
+
+    [[nodiscard]] constexpr const char* modeName(Mode mode) noexcept {
+        switch (mode) {
+        case Mode::Injector: return "INJECTOR";
+        case Mode::Pool:     return "POOL";
+        default:             return "INLINE";
+        }
+    }
+
+    // Single producer, single consumer. Each side caches the other's index so a
+    // push or pop touches the shared cache line only when the cached view says
+    // the ring is full or empty.
+    template <typename T, size_t Capacity>
+    class SpscRing {
+        static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+    public:
+        bool push(const T& value) noexcept {
+            const size_t t = tail.load(std::memory_order_relaxed);
+            if (t - headSeen == Capacity) {
+                headSeen = head.load(std::memory_order_acquire);
+                if (t - headSeen == Capacity)
+                    return false;
+            }
+            slots[t & (Capacity - 1)] = value;
+            tail.store(t + 1, std::memory_order_release);
+            return true;
+        }
+
+        bool pop(T& value) noexcept {
+            const size_t h = head.load(std::memory_order_relaxed);
+            if (h == tailSeen) {
+                tailSeen = tail.load(std::memory_order_acquire);
+                if (h == tailSeen)
+                    return false;
+            }
+            value = slots[h & (Capacity - 1)];
+            head.store(h + 1, std::memory_order_release);
+            return true;
+        }
+
+    private:
+        alignas(64) std::atomic<size_t> head{ 0 };   // consumer side
+        size_t tailSeen = 0;
+        alignas(64) std::atomic<size_t> tail{ 0 };   // producer side
+        size_t headSeen = 0;
+        alignas(64) std::array<T, Capacity> slots{};
+    };
+
+    // TSC ticks from a batch becoming due to its first event being injected.
+    // One thread records at a time; any thread may read.
+    struct Latency {
+        std::atomic<uint64_t> batches{ 0 };
+        std::atomic<uint64_t> totalTicks{ 0 };
+        std::atomic<uint64_t> maxTicks{ 0 };
+
+        void record(uint64_t ticks) noexcept {
+            batches.store(batches.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            totalTicks.store(totalTicks.load(std::memory_order_relaxed) + ticks, std::memory_order_relaxed);
+            if (ticks > maxTicks.load(std::memory_order_relaxed))
+                maxTicks.store(ticks, std::memory_order_relaxed);
+        }
+
+        void reset() noexcept {
+            batches.store(0, std::memory_order_relaxed);
+            totalTicks.store(0, std::memory_order_relaxed);
+            maxTicks.store(0, std::memory_order_relaxed);
+        }
+    };
+
+    // SendInput calls made per batch, against the key sequences they carried (one
+    // call each without gathering), and chord spread: TSC ticks from the start of
+    // a batch's first call to the end of its last. One thread records at a time.
+    struct InputCalls {
+        std::atomic<uint64_t> batches{ 0 };
+        std::atomic<uint64_t> calls{ 0 };
+        std::atomic<uint64_t> sequences{ 0 };
+        std::atomic<uint64_t> spreadTicks{ 0 };
+        std::atomic<uint64_t> maxSpreadTicks{ 0 };
+
+        void record(uint64_t batchCalls, uint64_t batchSequences, uint64_t spread) noexcept {
+            batches.store(batches.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            calls.store(calls.load(std::memory_order_relaxed) + batchCalls, std::memory_order_relaxed);
+            sequences.store(sequences.load(std::memory_order_relaxed) + batchSequences, std::memory_order_relaxed);
+            spreadTicks.store(spreadTicks.load(std::memory_order_relaxed) + spread, std::memory_order_relaxed);
+            if (spread > maxSpreadTicks.load(std::memory_order_relaxed))
+                maxSpreadTicks.store(spread, std::memory_order_relaxed);
+        }
+
+        void reset() noexcept {
+            batches.store(0, std::memory_order_relaxed);
+            calls.store(0, std::memory_order_relaxed);
+            sequences.store(0, std::memory_order_relaxed);
+            spreadTicks.store(0, std::memory_order_relaxed);
+            maxSpreadTicks.store(0, std::memory_order_relaxed);
+        }
+    };
+}
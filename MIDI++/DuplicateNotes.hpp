@@ -0,0 +1,56 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <utility>
+
+// Finds presses of a key that another copy of the part already struck within
+// `window`: arrangements doubled across tracks, or one note stacked on several
+// channels. Duplicates stay in the schedule tagged with the leading press's
+// track and playback skips them while that track is audible, so muting or
+// soloing never silences a note that only the muted copy would have played.
+class DuplicateNoteFilter {
+public:
+    using Time = std::chrono::nanoseconds;
+    static constexpr int NONE = -1;
+
+    DuplicateNoteFilter(bool enabled, Time window) noexcept : enabled(enabled), window(window) {}
+
+    // Track of the press this one duplicates, or NONE if it leads a new group.
+    int press(int note, Time time, int track) {
+        Group& group = groups[note & 0x7F];
+        if (enabled && group.open && time - group.start <= window) {
+            ++duplicates;
+            ++byTracks[{ track, group.track }];
+            return group.track;
+        }
+        group = { time, track, true };
+        return NONE;
+    }
+
+    // A release after the leading press lifts the key, so a later press is a new strike.
+    // Releases at the same instant run before presses and leave the group alone.
+    void release(int note, Time time) noexcept {
+        Group& group = groups[note & 0x7F];
+        if (group.open && time > group.start)
+            group.open = false;
+    }
+
+    [[nodiscard]] uint64_t duplicateCount() const noexcept { return duplicates; }
+    // (duplicate track, leading track) -> presses covered.
+    [[nodiscard]] const std::map<std::pair<int, int>, uint32_t>& pairs() const noexcept { return byTracks; }
+
+private:
+    struct Group {
+        Time start{};
+        int track = NONE;
+        bool open = false;
+    };
+
+    bool enabled;
+    Time window;
+    std::array<Group, 128> groups{};
+    uint64_t duplicates = 0;
+    std::map<std::pair<int, int>, uint32_t> byTracks;
+};
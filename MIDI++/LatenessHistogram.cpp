@@ -0,0 +1,106 @@
+#include "LatenessHistogram.hpp"
+#include <algorithm>
+#include <bit>
+
+namespace timing {
+
+    size_t LatenessHistogram::bucketOf(uint64_t ns) noexcept {
+        if (ns < SUB_BUCKETS)
+            return static_cast<size_t>(ns);
+        const int exponent = std::bit_width(ns) - 1;
+        if (exponent > MAX_EXPONENT)
+            return BUCKET_COUNT - 1;
+        // The top SUB_BITS + 1 bits pick the bucket; the leading one is implied.
+        const size_t sub = static_cast<size_t>(ns >> (exponent - SUB_BITS)) - SUB_BUCKETS;
+        return SUB_BUCKETS + static_cast<size_t>(exponent - SUB_BITS) * SUB_BUCKETS + sub;
+    }
+
+    int64_t LatenessHistogram::upperBound(size_t bucket) noexcept {
+        if (bucket < SUB_BUCKETS)
+            return static_cast<int64_t>(bucket);
+        const int shift = static_cast<int>((bucket - SUB_BUCKETS) / SUB_BUCKETS);
+        const uint64_t sub = (bucket - SUB_BUCKETS) % SUB_BUCKETS;
+        return static_cast<int64_t>(((SUB_BUCKETS + sub + 1) << shift) - 1);
+    }
+
+    void LatenessHistogram::record(int64_t lateNs, int64_t songNs, int note, int track) noexcept {
+        lateNs = std::max<int64_t>(lateNs, 0);
+        auto& bucket = counts[bucketOf(static_cast<uint64_t>(lateNs))];
+        bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        total.store(total.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        sumNs.store(sumNs.load(std::memory_order_relaxed) + lateNs, std::memory_order_relaxed);
+        if (lateNs > highest.load(std::memory_order_relaxed))
+            highest.store(lateNs, std::memory_order_relaxed);
+
+        if (offenderCount < WORST_KEPT) {
+            offenders[offenderCount++] = { lateNs, songNs, note, track };
+        }
+        else if (lateNs > offenders[mildest].lateNs) {
+            offenders[mildest] = { lateNs, songNs, note, track };
+        }
+        else {
+            return;
+        }
+        if (offenderCount == WORST_KEPT) {
+            mildest = 0;
+            for (size_t i = 1; i < WORST_KEPT; ++i) {
+                if (offenders[i].lateNs < offenders[mildest].lateNs)
+                    mildest = i;
+            }
+        }
+    }
+
+    void LatenessHistogram::reset() noexcept {
+        for (auto& bucket : counts)
+            bucket.store(0, std::memory_order_relaxed);
+        total.store(0, std::memory_order_relaxed);
+        sumNs.store(0, std::memory_order_relaxed);
+        highest.store(0, std::memory_order_relaxed);
+        offenderCount = 0;
+        mildest = 0;
+    }
+
+    double LatenessHistogram::meanNs() const noexcept {
+        const uint64_t n = count();
+        return n ? double(sumNs.load(std::memory_order_relaxed)) / double(n) : 0.0;
+    }
+
+    int64_t LatenessHistogram::percentileNs(double q) const noexcept {
+        const uint64_t n = count();
+        if (n == 0)
+            return 0;
+        // Rank of the quantile, 1-based: the smallest bucket covering it.
+        const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::clamp(q, 0.0, 1.0) * double(n) + 0.5));
+        uint64_t seen = 0;
+        for (size_t b = 0; b < BUCKET_COUNT; ++b) {
+            seen += counts[b].load(std::memory_order_relaxed);
+            if (seen >= rank)
+                return std::min(upperBound(b), maxNs());
+        }
+        return maxNs();
+    }
+
+    uint64_t LatenessHistogram::countAbove(int64_t ns) const noexcept {
+        uint64_t above = 0;
+        for (size_t b = bucketOf(static_cast<uint64_t>(std::max<int64_t>(ns, 0))) + 1; b < BUCKET_COUNT; ++b)
+            above += counts[b].load(std::memory_order_relaxed);
+        return above;
+    }
+
+    std::vector<LatenessHistogram::Offender> LatenessHistogram::worst() const {
+        std::vector<Offender> result(offenders.begin(), offenders.begin() + offenderCount);
+        std::sort(result.begin(), result.end(),
+                  [](const Offender& a, const Offender& b) { return a.lateNs > b.lateNs; });
+        return result;
+    }
+
+    std::vector<std::pair<int64_t, uint64_t>> LatenessHistogram::buckets() const {
+        std::vector<std::pair<int64_t, uint64_t>> result;
+        for (size_t b = 0; b < BUCKET_COUNT; ++b) {
+            const uint64_t n = counts[b].load(std::memory_order_relaxed);
+            if (n)
+                result.emplace_back(upperBound(b), n);
+        }
+        return result;
+    }
+}
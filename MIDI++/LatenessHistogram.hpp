@@ -0,0 +1,63 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace timing {
+
+    // How late injected events were, bucketed HDR-style: exact below 32 ns, then
+    // 32 buckets per power of two (about 3% resolution) up to 2^40 ns. Recording
+    // is a bit scan and a few relaxed stores, made by one thread at a time (the
+    // playback thread or the injector). Read it once playback has drained, as on
+    // pause; a concurrent read sees counts that may trail by a few events.
+    class LatenessHistogram {
+    public:
+        static constexpr int64_t TARGET_NS = 100'000;    // the accuracy playback aims for
+        static constexpr int64_t LATE_NS = 1'000'000;    // late enough to hear
+        static constexpr size_t WORST_KEPT = 8;
+
+        struct Offender {
+            int64_t lateNs;
+            int64_t songNs;      // the event's scheduled song position
+            int note;
+            int track;
+        };
+
+        void record(int64_t lateNs, int64_t songNs, int note, int track) noexcept;
+        void reset() noexcept;
+
+        [[nodiscard]] uint64_t count() const noexcept { return total.load(std::memory_order_relaxed); }
+        [[nodiscard]] int64_t maxNs() const noexcept { return highest.load(std::memory_order_relaxed); }
+        [[nodiscard]] double meanNs() const noexcept;
+        // Upper bound of the bucket holding the q-th quantile, capped at maxNs().
+        [[nodiscard]] int64_t percentileNs(double q) const noexcept;
+        // Events later than ns, at bucket resolution.
+        [[nodiscard]] uint64_t countAbove(int64_t ns) const noexcept;
+        // Most late first.
+        [[nodiscard]] std::vector<Offender> worst() const;
+        // (bucket upper bound in ns, events) for every non-empty bucket.
+        [[nodiscard]] std::vector<std::pair<int64_t, uint64_t>> buckets() const;
+
+    private:
+        static constexpr int SUB_BITS = 5;
+        static constexpr size_t SUB_BUCKETS = size_t(1) << SUB_BITS;
+        static constexpr int MAX_EXPONENT = 40;
+        static constexpr size_t BUCKET_COUNT = SUB_BUCKETS + (MAX_EXPONENT - SUB_BITS + 1) * SUB_BUCKETS;
+
+        static size_t bucketOf(uint64_t ns) noexcept;
+        static int64_t upperBound(size_t bucket) noexcept;
+
+        std::array<std::atomic<uint64_t>, BUCKET_COUNT> counts{};
+        std::atomic<uint64_t> total{ 0 };
+        std::atomic<int64_t> sumNs{ 0 };
+        std::atomic<int64_t> highest{ 0 };
+
+        // Writer-side only: the WORST_KEPT most late events, unordered.
+        std::array<Offender, WORST_KEPT> offenders{};
+        size_t offenderCount = 0;
+        size_t mildest = 0;      // index of the least late kept offender once full
+    };
+}
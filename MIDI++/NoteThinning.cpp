@@ -0,0 +1,76 @@
+#include "NoteThinning.hpp"
+#include <algorithm>
+
+namespace thinning {
+
+    namespace {
+        // Higher survives longer. Role in the chord dominates, then length and
+        // loudness; duplicates and drums sink below any pitched voice.
+        double importance(const Note& n, bool top, bool bottom, const Options& options) {
+            double score = n.velocity / 127.0;
+            if (top)
+                score += 2.0;
+            else if (bottom)
+                score += 1.0;
+            if (n.duration >= options.shortNote)
+                score += 0.5;
+            if (n.drum)
+                score -= 2.0;
+            if (n.duplicate)
+                score -= 4.0;
+            return score;
+        }
+    }
+
+    Result thin(std::span<const Note> notes, const Options& options, std::vector<bool>& keep) {
+        Result result;
+        result.requestedNotes = notes.size();
+        keep.assign(notes.size(), true);
+        if (notes.empty() || options.window.count() <= 0)
+            return result;
+
+        // Presses at one instant form a chord; its highest and lowest notes are the outer voices.
+        std::vector<double> scores(notes.size());
+        for (size_t first = 0; first < notes.size();) {
+            size_t last = first;
+            uint8_t high = notes[first].note, low = notes[first].note;
+            while (last < notes.size() && notes[last].time == notes[first].time) {
+                high = std::max(high, notes[last].note);
+                low = std::min(low, notes[last].note);
+                ++last;
+            }
+            for (size_t i = first; i < last; ++i)
+                scores[i] = importance(notes[i], notes[i].note == high, notes[i].note == low, options);
+            first = last;
+        }
+
+        const size_t notesPerWindow = options.maxKeysPerWindow / 2;
+        std::vector<size_t> order;
+        for (size_t first = 0; first < notes.size();) {
+            const int64_t windowIndex = notes[first].time.count() / options.window.count();
+            size_t last = first;
+            while (last < notes.size() && notes[last].time.count() / options.window.count() == windowIndex)
+                ++last;
+
+            const size_t count = last - first;
+            WindowStats stats{ windowIndex * options.window.count(), static_cast<uint32_t>(count * 2),
+                               static_cast<uint32_t>(count * 2) };
+            if (count > notesPerWindow) {
+                order.resize(count);
+                for (size_t i = 0; i < count; ++i)
+                    order[i] = first + i;
+                // Stable, so equal scores keep the earlier note.
+                std::stable_sort(order.begin(), order.end(),
+                                 [&](size_t a, size_t b) { return scores[a] > scores[b]; });
+                for (size_t i = notesPerWindow; i < count; ++i)
+                    keep[order[i]] = false;
+                result.droppedNotes += count - notesPerWindow;
+                ++result.windowsOverBudget;
+                stats.emitted = static_cast<uint32_t>(notesPerWindow * 2);
+            }
+            result.windows.push_back(stats);
+            first = last;
+        }
+        return result;
+    }
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Keeps the schedule of very dense files (black MIDI) within what SendInput and
+// the game can absorb: at most maxKeysPerWindow key events in each window, each
+// kept note costing a press and a release. Over-budget windows drop their least
+// important presses first: duplicates, drum tracks, inner chord voices, short
+// and quiet notes. The top voice of each chord, the melody, goes last.
+namespace thinning {
+
+    struct Options {
+        std::chrono::nanoseconds window{ std::chrono::milliseconds(50) };
+        uint32_t maxKeysPerWindow = 40;
+        std::chrono::nanoseconds shortNote{ std::chrono::milliseconds(25) };
+    };
+
+    // One press of the schedule, in time order.
+    struct Note {
+        std::chrono::nanoseconds time;
+        std::chrono::nanoseconds duration;   // until the key's next release; max() if never released
+        uint8_t note;
+        uint8_t velocity;
+        bool duplicate;                      // doubles an earlier press of the same key
+        bool drum;                           // on a drum-flagged track
+    };
+
+    struct WindowStats {
+        int64_t startNs;
+        uint32_t requested;                  // key events the schedule asked for
+        uint32_t emitted;                    // key events left after thinning
+    };
+
+    struct Result {
+        std::vector<WindowStats> windows;    // only windows that contain presses
+        uint64_t requestedNotes = 0;
+        uint64_t droppedNotes = 0;
+        size_t windowsOverBudget = 0;
+    };
+
+    // Sets keep[i] for every note; keep is resized to notes.size().
+    Result thin(std::span<const Note> notes, const Options& options, std::vector<bool>& keep);
+}
@@ -1,1648 +1,2763 @@
-﻿#include "PlaybackSystem.hpp"
-#include "InputHeader.h"
-#include "timer.h"  // <-- The improved "rdtsc_timer.h" you created
-#include <cmath>
-#include <algorithm>
-#include <future>
-#include <thread>
-#include <condition_variable>
-#include <iostream>
-#include "SplashScreen.h"
-
-#pragma comment(lib, "avrt.lib")
-
-// Local mutex for input operations.
-static std::mutex s_inputMutex;
-
-// Windows version query typedef.
-typedef LONG(WINAPI* RtlGetVersionPtr)(PRTL_OSVERSIONINFOW);
-
-//----------------------------------------------------------------
-// Global definitions.
-HANDLE VirtualPianoPlayer::command_event = nullptr;
-HANDLE VirtualPianoPlayer::waitable_timer = nullptr;
-double g_totalSongSeconds = 0.0;
-
-
-// We store this factor once we know the CPU frequency:
-// cyclesToNs = (1e9 / rdtsc_timer_get_frequency())
-// Combined with "current_speed" for playback rate adjustments
-static double cyclesToNs = 0.0;  // TSC cycles -> nanoseconds
-
-struct KeySequence {
-    std::vector<INPUT> events_press;
-    std::vector<INPUT> events_release;
-};
-static std::unordered_map<std::string, KeySequence> g_keyCache;
-
-const std::array<WORD, 256> VirtualPianoPlayer::SCAN_TABLE_AUTO = []() {
-    std::array<WORD, 256> table{};
-    table.fill(0);
-    // Numbers
-    table[static_cast<unsigned char>('1')] = 0x02;
-    table[static_cast<unsigned char>('2')] = 0x03;
-    table[static_cast<unsigned char>('3')] = 0x04;
-    table[static_cast<unsigned char>('4')] = 0x05;
-    table[static_cast<unsigned char>('5')] = 0x06;
-    table[static_cast<unsigned char>('6')] = 0x07;
-    table[static_cast<unsigned char>('7')] = 0x08;
-    table[static_cast<unsigned char>('8')] = 0x09;
-    table[static_cast<unsigned char>('9')] = 0x0A;
-    table[static_cast<unsigned char>('0')] = 0x0B;
-
-    // Lowercase letters
-    table[static_cast<unsigned char>('q')] = 0x10;
-    table[static_cast<unsigned char>('w')] = 0x11;
-    table[static_cast<unsigned char>('e')] = 0x12;
-    table[static_cast<unsigned char>('r')] = 0x13;
-    table[static_cast<unsigned char>('t')] = 0x14;
-    table[static_cast<unsigned char>('y')] = 0x15;
-    table[static_cast<unsigned char>('u')] = 0x16;
-    table[static_cast<unsigned char>('i')] = 0x17;
-    table[static_cast<unsigned char>('o')] = 0x18;
-    table[static_cast<unsigned char>('p')] = 0x19;
-    table[static_cast<unsigned char>('a')] = 0x1E;
-    table[static_cast<unsigned char>('s')] = 0x1F;
-    table[static_cast<unsigned char>('d')] = 0x20;
-    table[static_cast<unsigned char>('f')] = 0x21;
-    table[static_cast<unsigned char>('g')] = 0x22;
-    table[static_cast<unsigned char>('h')] = 0x23;
-    table[static_cast<unsigned char>('j')] = 0x24;
-    table[static_cast<unsigned char>('k')] = 0x25;
-    table[static_cast<unsigned char>('l')] = 0x26;
-    table[static_cast<unsigned char>('z')] = 0x2C;
-    table[static_cast<unsigned char>('x')] = 0x2D;
-    table[static_cast<unsigned char>('c')] = 0x2E;
-    table[static_cast<unsigned char>('v')] = 0x2F;
-    table[static_cast<unsigned char>('b')] = 0x30;
-    table[static_cast<unsigned char>('n')] = 0x31;
-    table[static_cast<unsigned char>('m')] = 0x32;
-
-    // Punctuation (shifted numbers)
-    table[static_cast<unsigned char>('!')] = 0x02;
-    table[static_cast<unsigned char>('@')] = 0x03;
-    table[static_cast<unsigned char>('#')] = 0x04;
-    table[static_cast<unsigned char>('$')] = 0x05;
-    table[static_cast<unsigned char>('%')] = 0x06;
-    table[static_cast<unsigned char>('^')] = 0x07;
-    table[static_cast<unsigned char>('&')] = 0x08;
-    table[static_cast<unsigned char>('*')] = 0x09;
-    table[static_cast<unsigned char>('(')] = 0x0A;
-    table[static_cast<unsigned char>(')')] = 0x0B;
-
-    // Uppercase letters (map same as lowercase)
-    table[static_cast<unsigned char>('Q')] = 0x10;
-    table[static_cast<unsigned char>('W')] = 0x11;
-    table[static_cast<unsigned char>('E')] = 0x12;
-    table[static_cast<unsigned char>('R')] = 0x13;
-    table[static_cast<unsigned char>('T')] = 0x14;
-    table[static_cast<unsigned char>('Y')] = 0x15;
-    table[static_cast<unsigned char>('U')] = 0x16;
-    table[static_cast<unsigned char>('I')] = 0x17;
-    table[static_cast<unsigned char>('O')] = 0x18;
-    table[static_cast<unsigned char>('P')] = 0x19;
-    table[static_cast<unsigned char>('A')] = 0x1E;
-    table[static_cast<unsigned char>('S')] = 0x1F;
-    table[static_cast<unsigned char>('D')] = 0x20;
-    table[static_cast<unsigned char>('F')] = 0x21;
-    table[static_cast<unsigned char>('G')] = 0x22;
-    table[static_cast<unsigned char>('H')] = 0x23;
-    table[static_cast<unsigned char>('J')] = 0x24;
-    table[static_cast<unsigned char>('K')] = 0x25;
-    table[static_cast<unsigned char>('L')] = 0x26;
-    table[static_cast<unsigned char>('Z')] = 0x2C;
-    table[static_cast<unsigned char>('X')] = 0x2D;
-    table[static_cast<unsigned char>('C')] = 0x2E;
-    table[static_cast<unsigned char>('V')] = 0x2F;
-    table[static_cast<unsigned char>('B')] = 0x30;
-    table[static_cast<unsigned char>('N')] = 0x31;
-    table[static_cast<unsigned char>('M')] = 0x32;
-    return table;
-}();
-
-
-std::pair<std::map<std::string, std::string>, std::map<std::string, std::string>>
-VirtualPianoPlayer::define_key_mappings() {
-    auto& cfg = midi::Config::getInstance();
-    return { cfg.key_mappings["LIMITED"], cfg.key_mappings["FULL"] };
-}
-
-// ------------------------------
-// KeySequence precomputation helper
-// ------------------------------
-static KeySequence computeKeySequence(const std::string& key) {
-    KeySequence seq;
-    // Detect modifiers
-    bool hasAlt  = (key.find("alt+")  != std::string::npos);
-    bool hasCtrl = (key.find("ctrl+") != std::string::npos);
-
-    char lastChar   = key.empty() ? '\0' : key.back();
-    bool shifted    = std::isupper(static_cast<unsigned char>(lastChar)) ||
-                      std::ispunct(static_cast<unsigned char>(lastChar));
-    char lookupChar = shifted ? static_cast<char>(std::tolower(lastChar)) : lastChar;
-
-    WORD mainScan   = VirtualPianoPlayer::SCAN_TABLE_AUTO[static_cast<unsigned char>(lookupChar)];
-    constexpr WORD SHIFT_SCAN = 0x2A;
-    constexpr WORD CTRL_SCAN  = 0x1D;
-    constexpr WORD ALT_SCAN   = 0x38;
-
-    // Build press sequence
-    std::vector<INPUT> pressSeq;
-    if (shifted && mainScan != 0) {
-        INPUT input = {};
-        input.type = INPUT_KEYBOARD;
-        input.ki.wScan = mainScan;
-        input.ki.dwFlags = KEYEVENTF_SCANCODE | KEYEVENTF_KEYUP;
-        pressSeq.push_back(input);
-    }
-    if (hasAlt) {
-        INPUT input = {};
-        input.type = INPUT_KEYBOARD;
-        input.ki.wScan = ALT_SCAN;
-        input.ki.dwFlags = KEYEVENTF_SCANCODE;
-        pressSeq.push_back(input);
-    }
-    if (hasCtrl) {
-        INPUT input = {};
-        input.type = INPUT_KEYBOARD;
-        input.ki.wScan = CTRL_SCAN;
-        input.ki.dwFlags = KEYEVENTF_SCANCODE;
-        pressSeq.push_back(input);
-    }
-    if (shifted) {
-        INPUT input = {};
-        input.type = INPUT_KEYBOARD;
-        input.ki.wScan = SHIFT_SCAN;
-        input.ki.dwFlags = KEYEVENTF_SCANCODE;
-        pressSeq.push_back(input);
-    }
-    if (mainScan != 0) {
-        INPUT input = {};
-        input.type = INPUT_KEYBOARD;
-        input.ki.wScan = mainScan;
-        input.ki.dwFlags = KEYEVENTF_SCANCODE;
-        pressSeq.push_back(input);
-    }
-    if (shifted) {
-        INPUT input = {};
-        input.type = INPUT_KEYBOARD;
-        input.ki.wScan = SHIFT_SCAN;
-        input.ki.dwFlags = KEYEVENTF_SCANCODE | KEYEVENTF_KEYUP;
-        pressSeq.push_back(input);
-    }
-    if (hasCtrl) {
-        INPUT input = {};
-        input.type = INPUT_KEYBOARD;
-        input.ki.wScan = CTRL_SCAN;
-        input.ki.dwFlags = KEYEVENTF_SCANCODE | KEYEVENTF_KEYUP;
-        pressSeq.push_back(input);
-    }
-    if (hasAlt) {
-        INPUT input = {};
-        input.type = INPUT_KEYBOARD;
-        input.ki.wScan = ALT_SCAN;
-        input.ki.dwFlags = KEYEVENTF_SCANCODE | KEYEVENTF_KEYUP;
-        pressSeq.push_back(input);
-    }
-
-    // Build release sequence (simulate full tap)
-    std::vector<INPUT> releaseSeq;
-    if (hasAlt) {
-        INPUT input = {};
-        input.type = INPUT_KEYBOARD;
-        input.ki.wScan = ALT_SCAN;
-        input.ki.dwFlags = KEYEVENTF_SCANCODE;
-        releaseSeq.push_back(input);
-    }
-    if (hasCtrl) {
-        INPUT input = {};
-        input.type = INPUT_KEYBOARD;
-        input.ki.wScan = CTRL_SCAN;
-        input.ki.dwFlags = KEYEVENTF_SCANCODE;
-        releaseSeq.push_back(input);
-    }
-    if (shifted) {
-        INPUT input = {};
-        input.type = INPUT_KEYBOARD;
-        input.ki.wScan = SHIFT_SCAN;
-        input.ki.dwFlags = KEYEVENTF_SCANCODE;
-        releaseSeq.push_back(input);
-    }
-    if (mainScan != 0) {
-        INPUT input = {};
-        input.type = INPUT_KEYBOARD;
-        input.ki.wScan = mainScan;
-        input.ki.dwFlags = KEYEVENTF_SCANCODE | KEYEVENTF_KEYUP;
-        releaseSeq.push_back(input);
-    }
-    if (shifted) {
-        INPUT input = {};
-        input.type = INPUT_KEYBOARD;
-        input.ki.wScan = SHIFT_SCAN;
-        input.ki.dwFlags = KEYEVENTF_SCANCODE | KEYEVENTF_KEYUP;
-        releaseSeq.push_back(input);
-    }
-    if (hasCtrl) {
-        INPUT input = {};
-        input.type = INPUT_KEYBOARD;
-        input.ki.wScan = CTRL_SCAN;
-        input.ki.dwFlags = KEYEVENTF_SCANCODE | KEYEVENTF_KEYUP;
-        releaseSeq.push_back(input);
-    }
-    if (hasAlt) {
-        INPUT input = {};
-        input.type = INPUT_KEYBOARD;
-        input.ki.wScan = ALT_SCAN;
-        input.ki.dwFlags = KEYEVENTF_SCANCODE | KEYEVENTF_KEYUP;
-        releaseSeq.push_back(input);
-    }
-    seq.events_press   = std::move(pressSeq);
-    seq.events_release = std::move(releaseSeq);
-    return seq;
-}
-
-NoteEvent::NoteEvent() noexcept
-    : time(std::chrono::nanoseconds::zero()),
-      note(""),
-      action(EventType::Press),
-      velocity(0),
-      isSustain(false),
-      sustainValue(0),
-      trackIndex(-1)
-{}
-
-NoteEvent::NoteEvent(std::chrono::nanoseconds t,
-                     std::string_view n,
-                     EventType a,
-                     int v,
-                     bool s,
-                     int sv,
-                     int trackIdx) noexcept
-    : time(t),
-      note(n),
-      action(a),
-      velocity(v),
-      isSustain(s),
-      sustainValue(sv),
-      trackIndex(trackIdx)
-{}
-
-bool NoteEvent::operator>(const NoteEvent& other) const noexcept {
-    return time > other.time;
-}
-
-//----------------------------------------------------------------
-// NoteEventPool Implementation.
-NoteEventPool::NoteEventPool()
-    : head(nullptr),
-      current(nullptr),
-      end(nullptr),
-      allocated_count(0)
-{
-    allocateNewBlock();
-}
-
-NoteEventPool::~NoteEventPool() {
-    while (head) {
-        Block* next = head->next;
-        _aligned_free(head);
-        head = next;
-    }
-}
-
-void NoteEventPool::allocateNewBlock() {
-    Block* newBlock = static_cast<Block*>(_aligned_malloc(sizeof(Block), CACHE_LINE_SIZE));
-    if (!newBlock)
-        throw std::bad_alloc();
-    newBlock->next = head;
-    head           = newBlock;
-    current        = newBlock->data;
-    end            = current + BLOCK_SIZE;
-}
-
-void NoteEventPool::reset() {
-    current = head->data;
-    allocated_count.store(0, std::memory_order_relaxed);
-}
-
-size_t NoteEventPool::getAllocatedCount() const {
-    return allocated_count.load(std::memory_order_relaxed);
-}
-
-//----------------------------------------------------------------
-// PlaybackControl Implementation.
-void PlaybackControl::requestSkip(std::chrono::seconds amount) {
-    std::lock_guard<std::mutex> lock(mutex);
-    pending_command = Command::SKIP;
-    command_amount  = amount;
-    command_processed.store(false, std::memory_order_release);
-    SetEvent(VirtualPianoPlayer::command_event); // Signal command event
-}
-
-void PlaybackControl::requestRewind(std::chrono::seconds amount) {
-    std::lock_guard<std::mutex> lock(mutex);
-    pending_command = Command::REWIND;
-    command_amount  = amount;
-    command_processed.store(false, std::memory_order_release);
-    SetEvent(VirtualPianoPlayer::command_event); // Signal command event
-}
-
-bool PlaybackControl::hasCommand() const {
-    return (pending_command != Command::NONE) &&
-           !command_processed.load(std::memory_order_acquire);
-}
-
-PlaybackControl::State PlaybackControl::processCommand(const State& current_state,
-                                                       double speed,
-                                                       size_t /*buffer_size*/)
-{
-    std::lock_guard<std::mutex> lock(mutex);
-    if (command_processed.load(std::memory_order_acquire))
-        return current_state;
-
-    State new_state = current_state;
-    auto scaled = std::chrono::duration_cast<std::chrono::nanoseconds>(
-        std::chrono::duration<double>(command_amount.count() * speed)
-    );
-
-    switch (pending_command) {
-    case Command::SKIP:
-        new_state.position += scaled;
-        new_state.needs_reset = true;
-        break;
-    case Command::REWIND:
-        new_state.position = (scaled > new_state.position)
-                             ? std::chrono::nanoseconds(0)
-                             : new_state.position - scaled;
-        new_state.needs_reset = true;
-        break;
-    default:
-        break;
-    }
-
-    command_processed.store(true, std::memory_order_release);
-    pending_command = Command::NONE;
-    return new_state;
-}
-
-//----------------------------------------------------------------
-// IsWin7OrWin8_Real: Check if OS is exactly Windows 7 or 8.
-bool IsWin7OrWin8_Real() {
-    HMODULE hNtdll = GetModuleHandleA("ntdll.dll");
-    if (!hNtdll)
-        return false;
-    auto pRtlGetVersion = reinterpret_cast<RtlGetVersionPtr>(
-        GetProcAddress(hNtdll, "RtlGetVersion"));
-    if (!pRtlGetVersion)
-        return false;
-
-    RTL_OSVERSIONINFOW info = {};
-    info.dwOSVersionInfoSize = sizeof(info);
-    if (pRtlGetVersion(&info) != 0)
-        return false;
-
-    return (info.dwMajorVersion == 6 &&
-           (info.dwMinorVersion == 1 || info.dwMinorVersion == 2));
-}
-//----------------------------------------------------------------
-// VirtualPianoPlayer Implementation.
-VirtualPianoPlayer::VirtualPianoPlayer() noexcept(false)
-    : processing_pool(std::thread::hardware_concurrency())
-{
-    ShowSplashScreen((HINSTANCE)GetModuleHandle(nullptr));
-
-    try {
-        midi::Config::getInstance().loadFromFile("config.json");
-    }
-    catch (const midi::ConfigException& e) {
-        std::cerr << "Configuration error: " << e.what()
-            << "\nLoading default settings...\n";
-        midi::Config::getInstance().setDefaults();
-        try {
-            midi::Config::getInstance().saveToFile("config.json");
-        }
-        catch (const midi::ConfigException& e2) {
-            std::cerr << "Failed to save default config: " << e2.what() << "\n";
-        }
-    }
-
-    if (IsWin7OrWin8_Real()) {
-        CloseSplashScreen();
-        MessageBoxA(nullptr,
-            "Incompatible OS detected.\nThis software requires Windows 8.1 or later.",
-            "Incompatibility Warning",
-            MB_ICONERROR | MB_OK);
-        throw std::runtime_error("Incompatible OS (Windows 7/8) detected");
-    }
-    TIMECAPS tc;
-    if (timeGetDevCaps(&tc, sizeof(tc)) == TIMERR_NOERROR) {
-        UINT minPeriod = std::max(1U, tc.wPeriodMin);
-        if (timeBeginPeriod(minPeriod) == TIMERR_NOERROR) {
-            m_timerResolutionSet = minPeriod;
-        }
-    }
-    auto mappings = define_key_mappings();
-    limited_key_mappings = std::move(mappings.first);
-    full_key_mappings = std::move(mappings.second);
-    note_buffer.reserve(1 << 20);
-    waitable_timer = CreateWaitableTimerEx(
-        nullptr,
-        nullptr,
-        CREATE_WAITABLE_TIMER_HIGH_RESOLUTION,
-        TIMER_ALL_ACCESS
-    );
-    if (!waitable_timer) {
-        waitable_timer = CreateWaitableTimer(nullptr, FALSE, nullptr);
-        if (!waitable_timer) {
-            CloseSplashScreen();
-            throw std::runtime_error("Failed to create waitable timer");
-        }
-    }
-    command_event = CreateEvent(nullptr, TRUE, FALSE, nullptr);
-    if (!command_event) {
-        CloseHandle(waitable_timer);
-        CloseSplashScreen();
-        throw std::runtime_error("Failed to create command event");
-    }
-    try {
-        sustain_key_code = stringToVK(midi::Config::getInstance().hotkeys.SUSTAIN_KEY);
-        volume_up_key_code = vkToScanCode(stringToVK(midi::Config::getInstance().hotkeys.VOLUME_UP_KEY));
-        volume_down_key_code = vkToScanCode(stringToVK(midi::Config::getInstance().hotkeys.VOLUME_DOWN_KEY));
-    }
-    catch (const std::exception& e) {
-        CloseSplashScreen();
-        throw std::runtime_error(std::string("Error mapping hotkeys: ") + e.what());
-    }
-
-    if (sustain_key_code == 0 || volume_up_key_code == 0 || volume_down_key_code == 0) {
-        CloseSplashScreen();
-        throw std::runtime_error("Invalid hotkey configuration. Check your config file.");
-    }
-
-    // 8) Start hotkey listener thread
-    hotkey_thread = std::make_unique<std::jthread>(&VirtualPianoPlayer::hotkey_listener, this);
-
-    // 9) Initialize RDTSC-based timer
-    rdtsc_timer_init();
-    if (rdtsc_timer_status() != RDTSC_TIMER_READY) {
-        CloseSplashScreen();
-        throw std::runtime_error("High-res TSC timer not available or calibration failed.");
-    }
-
-    double freq = rdtsc_timer_get_frequency(); // in Hz
-    if (freq <= 1e5) { // sanity check
-        CloseSplashScreen();
-        throw std::runtime_error("Measured TSC frequency is too low or invalid.");
-    }
-
-    // Convert cycles -> nanoseconds. Combine with current_speed
-    cyclesToNs = 1.0e9 / freq;
-    time_factor = cyclesToNs * current_speed;
-
-    SyscallNumber = GetNtUserSendInputSyscallNumber();
-    InitializeNtUserSendInputCall();
-    initializeKeyCache();
-    CloseSplashScreen();
-}
-
-VirtualPianoPlayer::~VirtualPianoPlayer() {
-    if (isSustainPressed) {
-        releaseKey(sustain_key_code);
-        isSustainPressed = false;
-    }
-
-    // Stop playback thread.
-    should_stop.store(true, std::memory_order_release);
-    signalPlayback();
-    if (playback_thread && playback_thread->joinable()) {
-        playback_thread->join();
-    }
-
-    if (command_event) {
-        CloseHandle(command_event);
-    }
-
-    if (waitable_timer) {
-        CloseHandle(waitable_timer);
-    }
-
-    if (m_timerResolutionSet != 0) {
-        timeEndPeriod(m_timerResolutionSet);
-        m_timerResolutionSet = 0;
-    }
-
-    // Now stop the hotkey thread.
-    hotkey_stop.store(true, std::memory_order_release);
-    if (hotkey_thread && hotkey_thread->joinable()) {
-        hotkey_thread->join();
-    }
-}
-
-std::chrono::nanoseconds VirtualPianoPlayer::get_adjusted_time() noexcept {
-    // If paused, just return the last total time
-    if (paused.load(std::memory_order_relaxed))
-        return total_adjusted_time;
-    uint64_t current_tsc = __rdtsc();
-    uint64_t tick_diff   = current_tsc - last_resume_tsc;
-
-    // (tick_diff) TSC cycles * cyclesToNs => nanoseconds
-    // We also scale by current_speed
-    double rawNs = double(tick_diff) * cyclesToNs * current_speed;
-    auto adjusted_ns = static_cast<std::chrono::nanoseconds::rep>(rawNs + 0.5);
-
-    return total_adjusted_time + std::chrono::nanoseconds(adjusted_ns);
-}
-
-void VirtualPianoPlayer::prepare_event_queue() {
-    std::lock_guard<std::mutex> lock(buffer_mutex);
-    note_buffer.clear();
-    event_pool.reset();
-
-    for (const auto& e : note_events) {
-        // e.action is an enum, so no string comparisons needed
-        EventType act = e.action;
-        auto time_ns  = e.time;
-        int vel       = e.velocity;
-        int tIdx      = e.trackIndex;
-
-        bool isSust   = (e.note_or_control == "sustain");
-        int sVal      = isSust ? (vel & 0xFF) : 0;
-        int realVel   = isSust ? 0 : vel;
-
-        note_buffer.push_back(event_pool.allocate(time_ns,
-                                                  e.note_or_control,
-                                                  act,
-                                                  realVel,
-                                                  isSust,
-                                                  sVal,
-                                                  tIdx));
-    }
-
-    std::stable_sort(note_buffer.begin(),
-                     note_buffer.end(),
-                     [](const NoteEvent* a, const NoteEvent* b) {
-                         return a->time < b->time;
-                     });
-}
-
-void VirtualPianoPlayer::play_notes() {
-    prepare_event_queue();
-
-    // Enable MMCSS for low-latency pro audio.
-    DWORD taskIndex = 0;
-    HANDLE mmcss_handle = AvSetMmThreadCharacteristics(L"Pro Audio", &taskIndex);
-    if (mmcss_handle) {
-        AvSetMmThreadPriority(mmcss_handle, AVRT_PRIORITY_CRITICAL);
-    }
-
-    if (!playback_started.load(std::memory_order_acquire)) {
-        playback_started.store(true, std::memory_order_release);
-        uint64_t now_tsc = __rdtsc();
-        playback_start_time = now_tsc;
-        last_resume_tsc     = now_tsc;
-    }
-
-    size_t buffer_size   = note_buffer.size();
-    size_t current_index = buffer_index.load(std::memory_order_acquire);
-
-    // Auto-transpose logic if enabled
-    if (midi::Config::getInstance().auto_transpose.ENABLED &&
-        [this]() {
-            int suggestedTransposition = toggle_transpose_adjustment();
-            int diff = suggestedTransposition - currentTransposition;
-            if (diff) {
-                std::cout << "Suggested Transposition: " << suggestedTransposition
-                          << "\n[Transpose] Adjusting by " << diff << " steps.\n";
-                [&]() -> bool {
-                    auto& cfg = midi::Config::getInstance().auto_transpose;
-                    WORD scanCode = MapVirtualKey(
-                        stringToVK(diff > 0 ? cfg.TRANSPOSE_UP_KEY
-                                            : cfg.TRANSPOSE_DOWN_KEY),
-                        MAPVK_VK_TO_VSC
-                    );
-                    int steps = std::abs(diff);
-                    // sleep before arrowsend to fix off-by-1 error
-                    for (int i = 0; i < steps; ++i) {
-                        Sleep(50);
-                        arrowsend(scanCode, true);
-                    }
-                    currentTransposition = suggestedTransposition;
-                    return true;
-                }();
-                return true;
-            }
-            return false;
-        }());
-
-    while (!should_stop.load(std::memory_order_acquire)) {
-        auto current_time = get_adjusted_time();
-
-        // Process any pending command events
-        if (WaitForSingleObject(command_event, 0) == WAIT_OBJECT_0) {
-            auto new_state = playback_control.processCommand(
-                { current_time, current_index, false },
-                current_speed,
-                buffer_size
-            );
-            if (new_state.needs_reset) {
-                current_index = find_next_event_index(new_state.position);
-                buffer_index.store(current_index, std::memory_order_release);
-                total_adjusted_time = new_state.position;
-                last_resume_tsc     = __rdtsc();
-            }
-            ResetEvent(command_event);
-        }
-
-        // If paused or at end, wait until resumed or commanded
-        if (paused.load(std::memory_order_acquire) || current_index >= buffer_size) {
-            std::unique_lock<std::mutex> lock(playback_cv_mutex);
-            playback_cv.wait_for(lock,
-                                 std::chrono::milliseconds(5),
-                                 [this]() {
-                return !paused.load() ||
-                        should_stop.load() ||
-                       (WaitForSingleObject(command_event, 0) == WAIT_OBJECT_0);
-            });
-            continue;
-        }
-
-        auto next_event_time = note_buffer[current_index]->time;
-        current_time = get_adjusted_time();
-
-        if (next_event_time > current_time) {
-            auto wait_duration = next_event_time - current_time;
-            std::unique_lock<std::mutex> lock(playback_cv_mutex);
-            playback_cv.wait_for(lock,
-                                 wait_duration,
-                                 [this]() {
-                return paused.load() ||
-                       (WaitForSingleObject(command_event, 0) == WAIT_OBJECT_0) ||
-                        should_stop.load();
-            });
-            continue;
-        }
-
-        // Process all events that are due
-        current_time = get_adjusted_time();
-        std::vector<NoteEvent*> batch;
-        while (current_index < buffer_size &&
-               note_buffer[current_index]->time <= current_time)
-        {
-            batch.push_back(note_buffer[current_index]);
-            ++current_index;
-        }
-        buffer_index.store(current_index, std::memory_order_release);
-
-        if (!batch.empty()) {
-            auto fut = processing_pool.enqueue([this, batch = std::move(batch)]() -> size_t {
-                // We release notes first, then press new ones
-                for (auto* e : batch) {
-                    if (e->action == EventType::Release) {
-                        execute_note_event(*e);
-                    }
-                }
-                for (auto* e : batch) {
-                    if (e->action == EventType::Press) {
-                        execute_note_event(*e);
-                    }
-                }
-                return batch.size();
-            });
-            fut.get();
-        }
-    }
-
-    if (mmcss_handle) {
-        AvRevertMmThreadCharacteristics(mmcss_handle);
-    }
-}
-
-size_t VirtualPianoPlayer::find_next_event_index(const std::chrono::nanoseconds& target_time) {
-    auto it = std::lower_bound(note_buffer.begin(),
-                               note_buffer.end(),
-                               target_time,
-                               [](const NoteEvent* e, const std::chrono::nanoseconds& t) {
-                                   return e->time < t;
-                               });
-    return std::distance(note_buffer.begin(), it);
-}
-
-void VirtualPianoPlayer::toggleSustainMode() {
-    switch (currentSustainMode) {
-    case SustainMode::IG:
-        currentSustainMode = SustainMode::SPACE_DOWN;
-        std::cout << "[SUSTAIN] DOWN cutoff=" << g_sustainCutoff << "\n";
-        break;
-    case SustainMode::SPACE_DOWN:
-        currentSustainMode = SustainMode::SPACE_UP;
-        std::cout << "[SUSTAIN] UP (inverted) cutoff=" << g_sustainCutoff << "\n";
-        break;
-    case SustainMode::SPACE_UP:
-        currentSustainMode = SustainMode::IG;
-        std::cout << "[SUSTAIN] IGNORE\n";
-        if (isSustainPressed) {
-            releaseKey(sustain_key_code);
-            isSustainPressed = false;
-        }
-        break;
-    }
-}
-
-void VirtualPianoPlayer::release_all_keys() {
-    if (isSustainPressed) {
-        releaseKey(sustain_key_code);
-        isSustainPressed = false;
-    }
-    const auto& mappings = (eightyEightKeyModeActive ? full_key_mappings
-                                                     : limited_key_mappings);
-    for (const auto& [note, key] : mappings) {
-        KeyPress(key, false);
-    }
-    for (auto& [n, state] : pressed_keys) {
-        state.store(false, std::memory_order_relaxed);
-    }
-    // Release alt/ctrl if pressed
-    releaseKey(VK_MENU);
-    releaseKey(VK_CONTROL);
-}
-
-void VirtualPianoPlayer::reset_volume() {
-    int diff  = midi::Config::getInstance().volume.INITIAL_VOLUME -
-                current_volume.load(std::memory_order_relaxed);
-    int steps = std::abs(diff) /
-                midi::Config::getInstance().volume.VOLUME_STEP;
-    WORD sc   = (diff > 0) ? volume_up_key_code : volume_down_key_code;
-    for (int i = 0; i < steps; ++i) {
-        arrowsend(sc, true);
-    }
-    current_volume.store(midi::Config::getInstance().volume.INITIAL_VOLUME,
-                         std::memory_order_relaxed);
-}
-
-void VirtualPianoPlayer::restart_song() {
-    try {
-        if (isSustainPressed) {
-            releaseKey(sustain_key_code);
-            isSustainPressed = false;
-        }
-        should_stop.store(true, std::memory_order_release);
-        signalPlayback();
-        if (playback_thread && playback_thread->joinable()) {
-            playback_thread->join();
-        }
-        processing_pool.clear_tasks();
-        playback_started.store(false, std::memory_order_release);
-        paused.store(false, std::memory_order_release);
-
-        constexpr auto initialBuffer = std::chrono::milliseconds(50);
-        total_adjusted_time = -initialBuffer;
-        current_speed       = 1.0;
-        buffer_index.store(0, std::memory_order_release);
-        release_all_keys();
-
-        uint64_t now_tsc = __rdtsc();
-        playback_start_time = now_tsc;
-        last_resume_tsc     = now_tsc;
-
-        should_stop.store(false, std::memory_order_release);
-        playback_thread = std::make_unique<std::jthread>(
-            &VirtualPianoPlayer::play_notes, this
-        );
-        std::cout << "[RESTART] Done.\n";
-    }
-    catch (const std::exception& e) {
-        std::cerr << "[RESTART] Error: " << e.what() << "\n";
-    }
-}
-
-void VirtualPianoPlayer::KeyPress(std::string_view key, bool press) {
-    std::string keyStr(key);
-    auto it = g_keyCache.find(keyStr);
-    if (it == g_keyCache.end()) {
-        KeySequence seq = computeKeySequence(keyStr);
-        it = g_keyCache.emplace(std::move(keyStr), std::move(seq)).first;
-    }
-    const auto& seq = it->second;
-    const auto& events = press ? seq.events_press : seq.events_release;
-    if (!events.empty()) {
-        NtUserSendInputCall(static_cast<UINT>(events.size()),
-                            const_cast<INPUT*>(events.data()),
-                            sizeof(INPUT));
-    }
-}
-
-int VirtualPianoPlayer::stringToVK(std::string_view keyName) {
-    static const std::unordered_map<std::string, int> keyMap = {
-        {"ENTER", VK_RETURN}, {"ESC", VK_ESCAPE}, {"SPACE", VK_SPACE},
-        {"UP", VK_UP}, {"DOWN", VK_DOWN}, {"LEFT", VK_LEFT}, {"RIGHT", VK_RIGHT},
-        {"CAPS", VK_CAPITAL}, {"SHIFT", VK_SHIFT}, {"CTRL", VK_CONTROL},
-        {"ALT", VK_MENU}, {"TAB", VK_TAB}, {"F1", VK_F1}, {"F2", VK_F2},
-        {"F3", VK_F3}, {"F4", VK_F4}, {"F5", VK_F5}, {"F6", VK_F6},
-        {"F7", VK_F7}, {"F8", VK_F8}, {"F9", VK_F9}, {"F10", VK_F10},
-        {"F11", VK_F11}, {"F12", VK_F12}, {"PAUSE", VK_PAUSE},
-        {"BACK", VK_BACK}, {"DELETE", VK_DELETE}, {"HOME", VK_HOME},
-        {"END", VK_END}, {"INSERT", VK_INSERT}, {"PGUP", VK_PRIOR},
-        {"PGDN", VK_NEXT}, {"NUMLOCK", VK_NUMLOCK}, {"SCROLL", VK_SCROLL},
-        {"PRTSC", VK_SNAPSHOT}, {"APPS", VK_APPS},
-        {"VOLUME_MUTE", VK_VOLUME_MUTE}, {"VOLUME_DOWN", VK_VOLUME_DOWN},
-        {"VOLUME_UP", VK_VOLUME_UP}, {"MEDIA_NEXT", VK_MEDIA_NEXT_TRACK},
-        {"MEDIA_PREV", VK_MEDIA_PREV_TRACK}, {"MEDIA_PLAY", VK_MEDIA_PLAY_PAUSE}
-    };
-
-    std::string upper;
-    upper.reserve(keyName.size());
-    for (char c : keyName) {
-        upper.push_back(static_cast<char>(std::toupper(static_cast<unsigned char>(c))));
-    }
-
-    // strip "VK_" prefix if present
-    if (upper.rfind("VK_", 0) == 0) {
-        upper.erase(0, 3);
-    }
-    else if (upper.rfind("VK", 0) == 0) {
-        upper.erase(0, 2);
-    }
-
-    auto it = keyMap.find(upper);
-    if (it != keyMap.end()) {
-        return it->second;
-    }
-
-    // If single alphanumeric char, try VkKeyScanA
-    if (upper.size() == 1) {
-        char c = upper[0];
-        if (std::isalnum(static_cast<unsigned char>(c))) {
-            SHORT vk = VkKeyScanA(c);
-            if (vk != -1)
-                return LOBYTE(vk);
-        }
-    }
-
-    // If that fails, try numeric parse
-    try {
-        int vkCode = std::stoi(upper);
-        if (vkCode >= 0 && vkCode <= 255) {
-            return vkCode;
-        }
-    }
-    catch (...) {
-        // ignore
-    }
-    throw std::runtime_error(
-        "Cannot map key '" + std::string(keyName) + "' to a VK code"
-    );
-}
-
-WORD VirtualPianoPlayer::vkToScanCode(int vk) {
-    return static_cast<WORD>(MapVirtualKey(vk, MAPVK_VK_TO_VSC));
-}
-
-void VirtualPianoPlayer::sendVirtualKey(WORD vk, bool press) {
-    INPUT in{};
-    in.type    = INPUT_KEYBOARD;
-    in.ki.wVk  = vk;
-    in.ki.wScan= static_cast<WORD>(MapVirtualKey(vk, MAPVK_VK_TO_VSC));
-    if (!press) {
-        in.ki.dwFlags |= KEYEVENTF_KEYUP;
-    }
-    NtUserSendInputCall(1, &in, sizeof(INPUT));
-}
-
-void VirtualPianoPlayer::pressKey(WORD vk) {
-    sendVirtualKey(vk, true);
-}
-
-void VirtualPianoPlayer::releaseKey(WORD vk) {
-    sendVirtualKey(vk, false);
-}
-
-void VirtualPianoPlayer::press_key(std::string_view note) noexcept {
-    std::string actual = ENABLE_OUT_OF_RANGE_TRANSPOSE
-                         ? transpose_note(note)
-                         : std::string(note);
-    const std::string& key = (eightyEightKeyModeActive
-                              ? full_key_mappings[actual]
-                              : limited_key_mappings[actual]);
-    if (!key.empty()) {
-        // if it wasn't already pressed, press it
-        if (!pressed_keys[actual].exchange(true, std::memory_order_relaxed)) {
-            KeyPress(key, true);
-        }
-        else {
-            // If it was already pressed, do a quick release/re-press
-            KeyPress(key, false);
-            KeyPress(key, true);
-        }
-    }
-}
-
-void VirtualPianoPlayer::release_key(std::string_view note) noexcept {
-    const std::string& key = (eightyEightKeyModeActive
-                              ? full_key_mappings[std::string(note)]
-                              : limited_key_mappings[std::string(note)]);
-    if (!key.empty() &&
-        pressed_keys[std::string(note)].exchange(false, std::memory_order_relaxed))
-    {
-        KeyPress(key, false);
-    }
-}
-
-std::string VirtualPianoPlayer::transpose_note(std::string_view note) {
-    int midi_n = note_name_to_midi(note);
-    int transposed = (midi_n < 36) ? 36 + (midi_n % 12)
-                     : (midi_n > 96) ? 96 - (11 - (midi_n % 12))
-                     : midi_n;
-    if (transposed > midi_n + 24) {
-        transposed = midi_n + 24;
-    }
-    else if (transposed < midi_n - 24) {
-        transposed = midi_n - 24;
-    }
-    return get_note_name(transposed);
-}
-
-int VirtualPianoPlayer::note_name_to_midi(std::string_view note_name) {
-    static constexpr const char* NAMES[12] = {
-        "C","C#","D","D#","E","F","F#","G","G#","A","A#","B"
-    };
-    if (note_name.size() < 2)
-        return 60;
-    int octave = note_name.back() - '0';
-    std::string_view pitch = note_name.substr(0, note_name.size() - 1);
-    int idx = 0;
-    for (int i = 0; i < 12; ++i) {
-        if (pitch == NAMES[i]) {
-            idx = i;
-            break;
-        }
-    }
-    return (octave + 1) * 12 + idx;
-}
-
-std::string VirtualPianoPlayer::get_note_name(int midi_note) {
-    static constexpr const char* NAMES[12] = {
-        "C","C#","D","D#","E","F","F#","G","G#","A","A#","B"
-    };
-    int octave = (midi_note / 12) - 1;
-    int pitch  = midi_note % 12;
-    if (pitch < 0 || pitch > 11)
-        return "Unknown";
-    return std::string(NAMES[pitch]) + std::to_string(octave);
-}
-
-std::string VirtualPianoPlayer::getVelocityCurveName(midi::VelocityCurveType curveType) {
-    using VT = midi::VelocityCurveType;
-    switch (curveType) {
-    case VT::LinearCoarse:       return "Linear Coarse";
-    case VT::LinearFine:         return "Linear Fine";
-    case VT::ImprovedLowVolume:  return "Improved Low Volume";
-    case VT::Logarithmic:        return "Logarithmic";
-    case VT::Exponential:        return "Exponential";
-    default:                     return "Unknown";
-    }
-}
-
-void VirtualPianoPlayer::setVelocityCurveIndex(size_t index) {
-    auto& cfg = midi::Config::getInstance();
-    size_t mx = 5 + cfg.playback.customVelocityCurves.size();
-    currentVelocityCurveIndex = std::min(index, mx);
-}
-
-std::string VirtualPianoPlayer::getVelocityKey(int targetVelocity) {
-    static constexpr std::array<int, 32> builtinCurves[5] = {
-        {4,8,12,16,20,24,28,32,36,40,44,48,52,56,60,64,68,72,76,80,84,88,92,96,100,104,108,112,116,120,124,127},
-        {2,6,10,14,18,22,26,30,34,38,42,46,50,54,58,62,66,70,74,78,82,86,90,94,98,102,106,110,114,118,122,127},
-        {1,3,5,7,10,13,16,20,24,29,34,40,46,53,60,68,76,85,94,104,114,120,123,127,127,127,127,127,127,127,127,127},
-        {1,2,3,5,7,10,14,19,25,32,40,49,60,72,85,99,115,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127},
-        {1,2,4,8,16,24,32,40,48,56,64,72,80,88,96,104,110,115,120,124,126,127,127,127,127,127,127,127,127,127,127,127}
-    };
-    static constexpr char velocityKeys[] = "1234567890qwertyuiopasdfghjklzxc";
-    const auto& config = midi::Config::getInstance();
-    const auto& velocityTable = (currentVelocityCurveIndex < 5)
-        ? builtinCurves[currentVelocityCurveIndex]
-        : config.playback.customVelocityCurves[currentVelocityCurveIndex - 5].velocityValues;
-
-    int idx = 0;
-    while (idx < 32 && velocityTable[idx] < targetVelocity) {
-        ++idx;
-    }
-    return std::string(1, velocityKeys[(idx < 32) ? idx : 31]);
-}
-
-void VirtualPianoPlayer::toggle_88_key_mode() {
-    eightyEightKeyModeActive = !eightyEightKeyModeActive;
-    std::cout << "[88-KEY MODE] "
-              << (eightyEightKeyModeActive ? "Enabled" : "Disabled")
-              << "\n";
-}
-
-void VirtualPianoPlayer::toggle_volume_adjustment() {
-    bool newVal = !enable_volume_adjustment.load(std::memory_order_relaxed);
-    enable_volume_adjustment.store(newVal, std::memory_order_relaxed);
-    if (newVal) {
-        max_volume = midi::Config::getInstance().volume.MAX_VOLUME;
-        precompute_volume_adjustments();
-        calibrate_volume();
-        std::cout << "[AUTOVOL] On. Initial="
-                  << midi::Config::getInstance().volume.INITIAL_VOLUME
-                  << "% Step="
-                  << midi::Config::getInstance().volume.VOLUME_STEP
-                  << "% Max="
-                  << midi::Config::getInstance().volume.MAX_VOLUME << "%\n";
-    }
-    else {
-        std::cout << "[AUTOVOL] Off.\n";
-    }
-}
-
-void VirtualPianoPlayer::toggle_velocity_keypress() {
-    bool newVal = !enable_velocity_keypress.load(std::memory_order_relaxed);
-    enable_velocity_keypress.store(newVal, std::memory_order_relaxed);
-    std::cout << "[VELOCITY KEY] "
-              << (newVal ? "Enabled" : "Disabled") << "\n";
-    if (newVal) {
-        std::cout << "[WARNING] ALT+key combos in use; ensure no conflicting overlays.\n";
-    }
-}
-
-void VirtualPianoPlayer::precompute_volume_adjustments() {
-    int currMaxVol = max_volume.load(std::memory_order_relaxed);
-    for (int v = 0; v < 128; ++v) {
-        double ratio = static_cast<double>(v) / 127.0;
-        int tv       = static_cast<int>(ratio * currMaxVol);
-        int mn       = std::min(midi::Config::getInstance().volume.MIN_VOLUME,
-                                currMaxVol);
-        int mx       = std::max(midi::Config::getInstance().volume.MIN_VOLUME,
-                                currMaxVol);
-        tv = std::clamp(tv, mn, mx);
-        // Round to nearest 10
-        tv = ((tv + 5) / 10) * 10;
-        volume_lookup[v] = tv;
-    }
-}
-
-void VirtualPianoPlayer::calibrate_volume() {
-    auto& vc = midi::Config::getInstance().volume;
-
-    // Force volume down many times
-    for (int i = 0; i < 50; ++i) {
-        arrowsend(volume_down_key_code, true);
-        for (volatile int j = 0; j < 8000; ++j) {} // small busy loop
-    }
-    double cf = (vc.INITIAL_VOLUME > 150) ? 1.1 : 1.0;
-    int steps = static_cast<int>(
-                    std::ceil(((vc.INITIAL_VOLUME - vc.MIN_VOLUME) /
-                                vc.VOLUME_STEP) * cf));
-
-    for (int i = 0; i < steps; ++i) {
-        arrowsend(volume_up_key_code, true);
-        for (volatile int j = 0; j < (8000 + (i > 10 ? (i - 10) * 300 : 0)); ++j) {}
-    }
-
-    current_volume.store(vc.INITIAL_VOLUME, std::memory_order_relaxed);
-}
-
-void VirtualPianoPlayer::AdjustVolumeBasedOnVelocity(int velocity) noexcept {
-    if (velocity < 0 || velocity >= static_cast<int>(volume_lookup.size()))
-        return;
-
-    int target_vol = volume_lookup[velocity];
-    int current_vol= current_volume.load(std::memory_order_relaxed);
-    int diff       = target_vol - current_vol;
-    int step_size  = midi::Config::getInstance().volume.VOLUME_STEP;
-    if (std::abs(diff) >= step_size) {
-        WORD sc = (diff > 0) ? volume_up_key_code : volume_down_key_code;
-        int steps = std::abs(diff) / step_size;
-        for (int i = 0; i < steps; ++i) {
-            arrowsend(sc, true);
-        }
-        current_volume.store(target_vol, std::memory_order_relaxed);
-    }
-}
-
-void VirtualPianoPlayer::toggle_out_of_range_transpose() {
-    ENABLE_OUT_OF_RANGE_TRANSPOSE = !ENABLE_OUT_OF_RANGE_TRANSPOSE;
-    std::cout << "[TRANSPOSE] "
-              << (ENABLE_OUT_OF_RANGE_TRANSPOSE ? "Enabled" : "Disabled")
-              << "\n";
-}
-
-int VirtualPianoPlayer::toggle_transpose_adjustment() {
-    auto [notes, durations] = transposeEngine.extractNotesAndDurations(midi_file);
-    if (notes.empty()) {
-        std::cout << "[TRANSPOSE] No notes.\n";
-        return 0;
-    }
-    std::string key   = transposeEngine.estimateKey(notes, durations);
-    std::string genre = transposeEngine.detectGenre(midi_file);
-    std::cout << "Detected key: " << key << "\nDetected genre: " << genre << "\n";
-    return transposeEngine.findBestTranspose(notes, durations, key, genre);
-}
-
-// Helpers for detect drums
-std::string getTrackName(const MidiTrack& track) {
-    if (!track.name.empty())
-        return track.name;
-    for (const auto& evt : track.events) {
-        if (evt.status == 0xFF && evt.data1 == 0x03 && !evt.metaData.empty())
-            return std::string(evt.metaData.begin(), evt.metaData.end());
-    }
-    return "(no name)";
-}
-
-double computeDrumConfidence(const MidiTrack& track) {
-    double confidence = 0.0;
-    std::string trackName = track.name;
-    if (trackName.empty()) {
-        for (const auto& evt : track.events) {
-            if (evt.status == 0xFF && evt.data1 == 0x03 && !evt.metaData.empty()) {
-                trackName = std::string(evt.metaData.begin(), evt.metaData.end());
-                break;
-            }
-        }
-    }
-    if (!trackName.empty()) {
-        std::string lowerName = trackName;
-        std::transform(lowerName.begin(), lowerName.end(),
-                       lowerName.begin(), ::tolower);
-        const std::vector<std::string> drumKeywords = {
-            "drum","drums","ezdrummer","addictive drums","superior drummer",
-            "bfd","drum kit","drumkit","percussion"
-        };
-        for (const auto& keyword : drumKeywords) {
-            if (lowerName.find(keyword) != std::string::npos) {
-                confidence += 1.0;
-                break;
-            }
-        }
-    }
-
-    int totalNotes=0, minPitch=INT_MAX, maxPitch=0, sumPitch=0;
-    std::unordered_map<int,int> pitchHistogram;
-    std::set<int> channels;
-    int noteOnCount=0, noteOffCount=0;
-    uint32_t firstTick=UINT_MAX, lastTick=0;
-
-    for (const auto& evt : track.events) {
-        uint8_t status = evt.status;
-        if ((status & 0xF0) == 0x90 || (status & 0xF0) == 0x80) {
-            ++totalNotes;
-            if ((status & 0xF0) == 0x90)
-                ++noteOnCount;
-            else
-                ++noteOffCount;
-            int pitch = evt.data1;
-            sumPitch  += pitch;
-            pitchHistogram[pitch]++;
-            firstTick  = std::min(firstTick, evt.absoluteTick);
-            lastTick   = std::max(lastTick, evt.absoluteTick);
-            channels.insert(status & 0x0F);
-            minPitch   = std::min(minPitch, pitch);
-            maxPitch   = std::max(maxPitch, pitch);
-        }
-    }
-    if (totalNotes == 0)
-        return confidence;
-
-    double noteOffRatio = static_cast<double>(noteOffCount) / totalNotes;
-    confidence += (noteOffRatio < 0.1 ? 0.1
-                  : (noteOffRatio > 0.3 ? -0.1 : 0.0));
-    int range = maxPitch - minPitch;
-    confidence += (range < 20 ? 0.3 : (range < 30 ? 0.2 : 0.0));
-
-    int maxCount = 0;
-    for (const auto& p : pitchHistogram) {
-        maxCount = std::max(maxCount, p.second);
-    }
-    double dominantRatio = static_cast<double>(maxCount) / totalNotes;
-    confidence += (dominantRatio > 0.7 ? 0.2
-                  : (dominantRatio > 0.5 ? 0.1 : 0.0));
-    double avgPitch = static_cast<double>(sumPitch) / totalNotes;
-    if (avgPitch >= 35 && avgPitch <= 81) {
-        confidence += 0.1;
-    }
-    if (channels.size() == 1 && *channels.begin() == 9) {
-        confidence += 0.5;
-    }
-    if (lastTick > firstTick) {
-        double density = static_cast<double>(totalNotes) /
-                         (lastTick - firstTick + 1);
-        if (density > 0.03) confidence += 0.05;
-        if (density > 0.05) confidence += 0.05;
-        if (density > 0.1)  confidence += 0.05;
-    }
-    std::vector<int> velocities;
-    for (const auto& evt : track.events) {
-        if (((evt.status & 0xF0) == 0x90) && evt.data2 > 0) {
-            velocities.push_back(evt.data2);
-        }
-    }
-    if (!velocities.empty()) {
-        double sumVel = 0.0;
-        for (int v : velocities) {
-            sumVel += v;
-        }
-        double meanVel = sumVel / velocities.size();
-        double variance= 0.0;
-        for (int v : velocities) {
-            variance += (v - meanVel)*(v - meanVel);
-        }
-        variance /= velocities.size();
-        if (std::sqrt(variance) < 10) {
-            confidence += 0.05;
-        }
-    }
-    return confidence;
-}
-
-void VirtualPianoPlayer::process_tracks(const MidiFile& mid) {
-    note_events.clear();
-    tempo_changes.clear();
-    timeSignatures.clear();
-    string_storage.clear();
-
-    bool smpte = (mid.division & 0x8000) != 0;
-    struct TempoPoint { uint64_t tick; uint64_t tempo; };
-    std::vector<TempoPoint> tempo_points;
-    if (!smpte) {
-        // default 120 bpm if no tempo is set
-        tempo_points.push_back({0, 500000ULL});
-    }
-
-    bool filterDrums = midi::Config::getInstance().midi.DETECT_DRUMS;
-    if (filterDrums) {
-        drum_flags.clear();
-        drum_flags.resize(mid.tracks.size(), false);
-        for (size_t i = 0; i < mid.tracks.size(); ++i) {
-            double conf = computeDrumConfidence(mid.tracks[i]);
-            double clampedConf = (conf > 1.0 ? 1.0 : conf);
-            double threshold   = (!getTrackName(mid.tracks[i]).empty())
-                                ? 0.8
-                                : 0.9;
-            if (clampedConf >= threshold) {
-                drum_flags[i] = true;
-                std::string trackName = getTrackName(mid.tracks[i]);
-                std::cout << "[DRUMS] Track #" << i
-                          << " \"" << trackName
-                          << "\" flagged as drums (confidence: "
-                          << std::fixed << std::setprecision(1)
-                          << clampedConf * 100 << "%, raw: "
-                          << conf << ")\n";
-            }
-        }
-    }
-
-    std::chrono::nanoseconds current_time_ns(0);
-    std::vector<std::tuple<uint64_t,int,MidiEvent>> all_events;
-    all_events.reserve(100000);
-
-    for (int trackIndex = 0;
-         trackIndex < static_cast<int>(mid.tracks.size());
-         ++trackIndex)
-    {
-        for (auto& evt : mid.tracks[trackIndex].events) {
-            all_events.push_back({evt.absoluteTick, trackIndex, evt});
-        }
-    }
-    std::sort(all_events.begin(),
-              all_events.end(),
-              [](auto& a, auto& b) {
-                  return std::get<0>(a) < std::get<0>(b);
-              });
-
-    size_t totalEvents = all_events.size();
-    string_storage.reserve(totalEvents * 3);
-
-    // For open notes
-    std::unordered_map<int,
-        std::unordered_map<int, std::vector<std::chrono::nanoseconds>>
-    > active_notes;
-
-    auto tick2ns = [&](uint64_t st, uint64_t en) -> std::chrono::nanoseconds {
-        if (smpte) {
-            int8_t fps_val = static_cast<int8_t>(mid.division >> 8);
-            int fps        = -fps_val;
-            uint8_t tpf    = static_cast<uint8_t>(mid.division & 0xFF);
-            uint64_t nspt  = 1000000000ULL / (fps * tpf);
-            return std::chrono::nanoseconds((en - st) * nspt);
-        }
-        else {
-            std::chrono::nanoseconds total_ns(0);
-            size_t tempo_idx = 0;
-            while (tempo_idx < tempo_points.size() - 1 &&
-                   tempo_points[tempo_idx + 1].tick <= st)
-            {
-                ++tempo_idx;
-            }
-            uint64_t current_tick = st;
-            while (current_tick < en) {
-                uint64_t nxt = (tempo_idx < tempo_points.size() - 1
-                                ? tempo_points[tempo_idx + 1].tick
-                                : en);
-                uint64_t seg = std::min(en - current_tick, nxt - current_tick);
-                // tempo in microseconds per quarter note
-                uint64_t nspt = (tempo_points[tempo_idx].tempo * 1000ULL) /
-                                 mid.division;
-                total_ns += std::chrono::nanoseconds(seg * nspt);
-                current_tick += seg;
-                if (current_tick >= nxt && tempo_idx < tempo_points.size() - 1) {
-                    ++tempo_idx;
-                }
-            }
-            return total_ns;
-        }
-    };
-
-    auto close_active_notes = [&](std::chrono::nanoseconds ctime) {
-        using NH = midi::NoteHandlingMode;
-        if (midi::Config::getInstance().playback.noteHandlingMode == NH::NoHandling) {
-            active_notes.clear();
-            return;
-        }
-        for (auto& [ch, notemap] : active_notes) {
-            for (auto& [note, starts] : notemap) {
-                while (!starts.empty()) {
-                    add_note_event(ctime, "C0", EventType::Release, 0, -1);
-                    if (midi::Config::getInstance().playback.noteHandlingMode
-                        == NH::LIFO)
-                    {
-                        starts.pop_back();
-                    }
-                    else {
-                        starts.erase(starts.begin());
-                    }
-                }
-            }
-        }
-        active_notes.clear();
-    };
-
-    uint64_t current_tick = 0;
-    for (auto& [tick, trackIdx, evt] : all_events) {
-        auto delta_ns = tick2ns(current_tick, tick);
-        current_time_ns += delta_ns;
-        current_tick     = tick;
-
-        // Tempo event
-        if (evt.status == 0xFF && evt.data1 == 0x51 && evt.metaData.size() == 3) {
-            uint32_t tempo_val = (static_cast<uint8_t>(evt.metaData[0]) << 16)
-                               | (static_cast<uint8_t>(evt.metaData[1]) << 8)
-                               | (static_cast<uint8_t>(evt.metaData[2]));
-            if (!smpte) {
-                tempo_points.push_back({tick, tempo_val});
-            }
-            tempo_changes.push_back({ static_cast<double>(tick),
-                                      static_cast<double>(tempo_val) });
-        }
-        else if (evt.status == 0xFF && evt.data1 == 0x58 && evt.metaData.size() == 4) {
-            TimeSignature ts;
-            ts.tick                     = tick;
-            ts.numerator                = evt.metaData[0];
-            ts.denominator              = static_cast<uint8_t>(1 << evt.metaData[1]);
-            ts.clocksPerClick           = evt.metaData[2];
-            ts.thirtySecondNotesPerQuarter= evt.metaData[3];
-            timeSignatures.push_back(ts);
-        }
-        else if ((evt.status & 0xF0) == 0xB0 && evt.data1 == 64) {
-            // sustain pedal
-            add_sustain_event(current_time_ns,
-                              evt.status & 0x0F,
-                              evt.data2,
-                              trackIdx);
-        }
-        else if ((evt.status & 0xF0) == 0x90 ||
-                 (evt.status & 0xF0) == 0x80)
-        {
-            int note     = evt.data1;
-            int channel  = evt.status & 0x0F;
-            int velocity = evt.data2;
-
-            if ((evt.status & 0xF0) == 0x90 && velocity > 0) {
-                handle_note_on(current_time_ns,
-                               channel,
-                               note,
-                               velocity,
-                               trackIdx,
-                               active_notes);
-            }
-            else {
-                handle_note_off(current_time_ns,
-                                channel,
-                                note,
-                                velocity,
-                                trackIdx,
-                                active_notes);
-            }
-        }
-    }
-    close_active_notes(current_time_ns);
-
-    std::stable_sort(note_events.begin(),
-                     note_events.end(),
-                     [](const RawNoteEvent& a, const RawNoteEvent& b) {
-                         return a.time < b.time;
-                     });
-}
-
-void VirtualPianoPlayer::handle_note_off(std::chrono::nanoseconds ctime,
-                                         int ch,
-                                         int note,
-                                         int vel,
-                                         int trackIndex,
-     std::unordered_map<int,std::unordered_map<int,std::vector<std::chrono::nanoseconds>>>& active_notes)
-{
-    std::string nn = get_note_name(note);
-    using NH = midi::NoteHandlingMode;
-    auto mode = midi::Config::getInstance().playback.noteHandlingMode;
-    if (mode == NH::NoHandling) {
-        string_storage.push_back(nn);
-        string_storage.push_back("release");
-        note_events.push_back({ ctime,
-                                std::string_view(string_storage[string_storage.size() - 2]),
-                                EventType::Release,
-                                vel,
-                                trackIndex });
-        return;
-    }
-    auto itCh = active_notes.find(ch);
-    if (itCh != active_notes.end()) {
-        auto& noteMap = itCh->second;
-        auto itN = noteMap.find(note);
-        if (itN != noteMap.end() && !itN->second.empty()) {
-            string_storage.push_back(nn);
-            string_storage.push_back("release");
-            note_events.push_back({ ctime,
-                                    std::string_view(string_storage[string_storage.size() - 2]),
-                                    EventType::Release,
-                                    vel,
-                                    trackIndex });
-            if (mode == NH::LIFO) {
-                itN->second.pop_back();
-            }
-            else {
-                itN->second.erase(itN->second.begin());
-            }
-        }
-    }
-}
-
-void VirtualPianoPlayer::handle_note_on(std::chrono::nanoseconds ctime,
-                                        int ch,
-                                        int note,
-                                        int vel,
-                                        int trackIndex,
-    std::unordered_map<int,std::unordered_map<int,std::vector<std::chrono::nanoseconds>>>& active_notes)
-{
-    std::string nm = get_note_name(note);
-    active_notes[ch][note].push_back(ctime);
-
-    string_storage.push_back(nm);
-    string_storage.push_back("press");
-    note_events.push_back({ ctime,
-                            std::string_view(string_storage[string_storage.size() - 2]),
-                            EventType::Press,
-                            vel,
-                            trackIndex });
-}
-
-void VirtualPianoPlayer::add_sustain_event(std::chrono::nanoseconds time,
-                                           int channel,
-                                           int sustainValue,
-                                           int trackIndex)
-{
-    string_storage.push_back("sustain");
-    EventType et = (sustainValue >= g_sustainCutoff)
-                   ? EventType::Press
-                   : EventType::Release;
-    string_storage.push_back((et == EventType::Press) ? "press" : "release");
-
-    note_events.push_back({ time,
-                            std::string_view(string_storage[string_storage.size() - 2]),
-                            et,
-                            (sustainValue | (channel << 8)),
-                            trackIndex });
-}
-
-void VirtualPianoPlayer::add_note_event(std::chrono::nanoseconds time,
-                                        std::string_view note,
-                                        EventType action,
-                                        int velocity,
-                                        int trackIndex)
-{
-    string_storage.push_back(std::string(note));
-    string_storage.push_back((action == EventType::Press)
-                             ? "press"
-                             : "release");
-    note_events.push_back({ time,
-                            std::string_view(string_storage[string_storage.size() - 2]),
-                            action,
-                            velocity,
-                            trackIndex });
-}
-
-void VirtualPianoPlayer::speed_up() {
-    adjust_playback_speed(1.1);
-}
-
-void VirtualPianoPlayer::slow_down() {
-    adjust_playback_speed(1.0 / 1.1);
-}
-
-void VirtualPianoPlayer::adjust_playback_speed(double factor) {
-    uint64_t now_tsc = __rdtsc();
-    if (!playback_started.load(std::memory_order_relaxed)) {
-        // If playback hasn’t started, initialize TSC but don’t adjust time yet
-        playback_start_time = now_tsc;
-        last_resume_tsc     = now_tsc;
-    }
-    else {
-        // Calculate how much time has elapsed at current_speed
-        uint64_t tick_diff = now_tsc - last_resume_tsc;
-        // Convert to nanoseconds
-        double elapsed_ns = double(tick_diff) * cyclesToNs * current_speed;
-        total_adjusted_time += std::chrono::nanoseconds(
-            static_cast<std::chrono::nanoseconds::rep>(elapsed_ns + 0.5)
-        );
-        last_resume_tsc = now_tsc;
-    }
-
-    // Adjust the playback speed
-    current_speed *= factor;
-    current_speed = std::clamp(current_speed, 0.25, 2.0);
-    if (std::fabs(current_speed - 1.0) < 0.05) {
-        current_speed = 1.0; // Snap to normal speed if close
-    }
-
-    // Update time_factor to reflect the new speed
-    time_factor = cyclesToNs * current_speed;
-    std::cout << "[SPEED] x" << current_speed << "\n";
-}
-
-void VirtualPianoPlayer::arrowsend(WORD sc, bool extended) {
-    INPUT in[2] = {};
-    in[0].type      = INPUT_KEYBOARD;
-    in[0].ki.wScan  = sc;
-    in[0].ki.dwFlags= KEYEVENTF_SCANCODE | (extended ? KEYEVENTF_EXTENDEDKEY : 0);
-
-    in[1].type      = INPUT_KEYBOARD;
-    in[1].ki.wScan  = sc;
-    in[1].ki.dwFlags= KEYEVENTF_SCANCODE | KEYEVENTF_KEYUP
-                      | (extended ? KEYEVENTF_EXTENDEDKEY : 0);
-
-    NtUserSendInputCall(2, in, sizeof(INPUT));
-}
-
-void VirtualPianoPlayer::hotkey_listener() {
-    int playPauseVK     = stringToVK(midi::Config::getInstance().hotkeys.PLAY_PAUSE_KEY);
-    int rewindVK        = stringToVK(midi::Config::getInstance().hotkeys.REWIND_KEY);
-    int skipVK          = stringToVK(midi::Config::getInstance().hotkeys.SKIP_KEY);
-    int emergencyExitVK = stringToVK(midi::Config::getInstance().hotkeys.EMERGENCY_EXIT_KEY);
-
-    bool wasPlayPause   = false;
-    bool wasRewind      = false;
-    bool wasSkip        = false;
-    bool wasEmergency   = false;
-
-    while (!hotkey_stop.load(std::memory_order_acquire)) {
-        bool playPauseDown  = (GetAsyncKeyState(playPauseVK) & 0x8000) != 0;
-        bool rewindDown     = (GetAsyncKeyState(rewindVK) & 0x8000) != 0;
-        bool skipDown       = (GetAsyncKeyState(skipVK) & 0x8000) != 0;
-        bool emergencyDown  = (GetAsyncKeyState(emergencyExitVK) & 0x8000) != 0;
-
-        if (playPauseDown && !wasPlayPause) {
-            // std::cout << "[DEBUG] F1 pressed (PLAY/PAUSE)\n";
-            toggle_play_pause();
-        }
-        if (rewindDown && !wasRewind) {
-            // std::cout << "[DEBUG] F2 pressed (REWIND)\n";
-            rewind(std::chrono::seconds(10));
-        }
-        if (skipDown && !wasSkip) {
-            // std::cout << "[DEBUG] F3 pressed (SKIP)\n";
-            skip(std::chrono::seconds(10));
-        }
-        if (emergencyDown && !wasEmergency) {
-            // std::cout << "[DEBUG] F4 pressed (EMERGENCY EXIT)\n";
-            emergency_exit();
-        }
-
-        wasPlayPause = playPauseDown;
-        wasRewind    = rewindDown;
-        wasSkip      = skipDown;
-        wasEmergency = emergencyDown;
-
-        std::this_thread::sleep_for(std::chrono::milliseconds(10));
-    }
-}
-
-void VirtualPianoPlayer::emergency_exit() {
-    std::cout << "[EMERGENCY] Emergency exit triggered. Stopping playback and exiting.\n";
-    should_stop.store(true, std::memory_order_release);
-    release_all_keys();
-    signalPlayback();
-    std::exit(1);
-}
-
+﻿#include "PlaybackSystem.hpp"
+#include "InputHeader.h"
+#include "timer.h"  // <-- The improved "rdtsc_timer.h" you created
+#include <cassert>
+#include <cmath>
+#include <algorithm>
+#include <future>
+#include <thread>
+#include <condition_variable>
+#include <iostream>
+#include <limits>
+#include "SplashScreen.h"
+
+#pragma comment(lib, "avrt.lib")
+
+// Local mutex for input operations.
+static std::mutex s_inputMutex;
+
+// Windows version query typedef.
+typedef LONG(WINAPI* RtlGetVersionPtr)(PRTL_OSVERSIONINFOW);
+
+//----------------------------------------------------------------
+// Global definitions.
+HANDLE VirtualPianoPlayer::command_event = nullptr;
+HANDLE VirtualPianoPlayer::waitable_timer = nullptr;
+double g_totalSongSeconds = 0.0;
+
+// How much of the song must be scheduled before play_notes starts the clock.
+static constexpr std::chrono::nanoseconds SCHEDULE_PRIME_WINDOW = std::chrono::seconds(3);
+
+
+// We store this factor once we know the CPU frequency:
+// cyclesToNs = (1e9 / rdtsc_timer_get_frequency())
+// Combined with "current_speed" for playback rate adjustments
+static double cyclesToNs = 0.0;  // TSC cycles -> nanoseconds
+
+struct KeySequence {
+    std::vector<INPUT> events_press;
+    std::vector<INPUT> events_release;
+};
+static std::unordered_map<std::string, KeySequence> g_keyCache;
+// Key sequence per MIDI note for each key layout, resolved once by initializeKeyCache.
+static std::array<const KeySequence*, 128> g_limitedNoteKeys{};
+static std::array<const KeySequence*, 128> g_fullNoteKeys{};
+
+// While this thread runs a dispatch batch, the key sequences it sends are gathered
+// here and go out together as the batch ends, in calls of at most `cap` INPUTs.
+// Everything else (hotkeys, release_all_keys, calibration) sends straight away.
+struct InputGather {
+    bool active = false;
+    size_t cap = 0;            // 0: one call per key sequence, as if not gathering
+    std::vector<INPUT> pending;
+    uint64_t calls = 0;
+    uint64_t sequences = 0;
+    uint64_t firstTsc = 0;     // start of the batch's first call
+    uint64_t lastTsc = 0;      // end of its last
+};
+static thread_local InputGather t_gather;
+
+static void callSendInput(InputGather& g, const INPUT* inputs, size_t count) noexcept {
+    const uint64_t start = __rdtsc();
+    if (g.calls++ == 0)
+        g.firstTsc = start;
+    NtUserSendInputCall(static_cast<UINT>(count), const_cast<INPUT*>(inputs), sizeof(INPUT));
+    g.lastTsc = __rdtsc();
+}
+
+static void flushInputs(InputGather& g) noexcept {
+    if (!g.pending.empty()) {
+        callSendInput(g, g.pending.data(), g.pending.size());
+        g.pending.clear();
+    }
+}
+
+static void sendInputs(const INPUT* inputs, size_t count) noexcept {
+    if (count == 0)
+        return;
+    InputGather& g = t_gather;
+    if (!g.active) {
+        NtUserSendInputCall(static_cast<UINT>(count), const_cast<INPUT*>(inputs), sizeof(INPUT));
+        return;
+    }
+    ++g.sequences;
+    if (g.cap == 0) {
+        callSendInput(g, inputs, count);
+        return;
+    }
+    // pending was reserved to cap, so this never allocates.
+    while (count) {
+        const size_t take = std::min(count, g.cap - g.pending.size());
+        g.pending.insert(g.pending.end(), inputs, inputs + take);
+        inputs += take;
+        count -= take;
+        if (g.pending.size() == g.cap)
+            flushInputs(g);
+    }
+}
+
+static void sendKeySequence(const KeySequence& seq, bool press) noexcept {
+    const auto& events = press ? seq.events_press : seq.events_release;
+    sendInputs(events.data(), events.size());
+}
+
+static void appendKeySequence(std::vector<INPUT>& out, const KeySequence& seq, bool press) {
+    const auto& events = press ? seq.events_press : seq.events_release;
+    out.insert(out.end(), events.begin(), events.end());
+}
+
+static INPUT virtualKeyInput(WORD vk, bool press) noexcept {
+    INPUT in{};
+    in.type    = INPUT_KEYBOARD;
+    in.ki.wVk  = vk;
+    in.ki.wScan= static_cast<WORD>(MapVirtualKey(vk, MAPVK_VK_TO_VSC));
+    if (!press) {
+        in.ki.dwFlags |= KEYEVENTF_KEYUP;
+    }
+    return in;
+}
+
+const std::array<WORD, 256> VirtualPianoPlayer::SCAN_TABLE_AUTO = []() {
+    std::array<WORD, 256> table{};
+    table.fill(0);
+    // Numbers
+    table[static_cast<unsigned char>('1')] = 0x02;
+    table[static_cast<unsigned char>('2')] = 0x03;
+    table[static_cast<unsigned char>('3')] = 0x04;
+    table[static_cast<unsigned char>('4')] = 0x05;
+    table[static_cast<unsigned char>('5')] = 0x06;
+    table[static_cast<unsigned char>('6')] = 0x07;
+    table[static_cast<unsigned char>('7')] = 0x08;
+    table[static_cast<unsigned char>('8')] = 0x09;
+    table[static_cast<unsigned char>('9')] = 0x0A;
+    table[static_cast<unsigned char>('0')] = 0x0B;
+
+    // Lowercase letters
+    table[static_cast<unsigned char>('q')] = 0x10;
+    table[static_cast<unsigned char>('w')] = 0x11;
+    table[static_cast<unsigned char>('e')] = 0x12;
+    table[static_cast<unsigned char>('r')] = 0x13;
+    table[static_cast<unsigned char>('t')] = 0x14;
+    table[static_cast<unsigned char>('y')] = 0x15;
+    table[static_cast<unsigned char>('u')] = 0x16;
+    table[static_cast<unsigned char>('i')] = 0x17;
+    table[static_cast<unsigned char>('o')] = 0x18;
+    table[static_cast<unsigned char>('p')] = 0x19;
+    table[static_cast<unsigned char>('a')] = 0x1E;
+    table[static_cast<unsigned char>('s')] = 0x1F;
+    table[static_cast<unsigned char>('d')] = 0x20;
+    table[static_cast<unsigned char>('f')] = 0x21;
+    table[static_cast<unsigned char>('g')] = 0x22;
+    table[static_cast<unsigned char>('h')] = 0x23;
+    table[static_cast<unsigned char>('j')] = 0x24;
+    table[static_cast<unsigned char>('k')] = 0x25;
+    table[static_cast<unsigned char>('l')] = 0x26;
+    table[static_cast<unsigned char>('z')] = 0x2C;
+    table[static_cast<unsigned char>('x')] = 0x2D;
+    table[static_cast<unsigned char>('c')] = 0x2E;
+    table[static_cast<unsigned char>('v')] = 0x2F;
+    table[static_cast<unsigned char>('b')] = 0x30;
+    table[static_cast<unsigned char>('n')] = 0x31;
+    table[static_cast<unsigned char>('m')] = 0x32;
+
+    // Punctuation (shifted numbers)
+    table[static_cast<unsigned char>('!')] = 0x02;
+    table[static_cast<unsigned char>('@')] = 0x03;
+    table[static_cast<unsigned char>('#')] = 0x04;
+    table[static_cast<unsigned char>('$')] = 0x05;
+    table[static_cast<unsigned char>('%')] = 0x06;
+    table[static_cast<unsigned char>('^')] = 0x07;
+    table[static_cast<unsigned char>('&')] = 0x08;
+    table[static_cast<unsigned char>('*')] = 0x09;
+    table[static_cast<unsigned char>('(')] = 0x0A;
+    table[static_cast<unsigned char>(')')] = 0x0B;
+
+    // Uppercase letters (map same as lowercase)
+    table[static_cast<unsigned char>('Q')] = 0x10;
+    table[static_cast<unsigned char>('W')] = 0x11;
+    table[static_cast<unsigned char>('E')] = 0x12;
+    table[static_cast<unsigned char>('R')] = 0x13;
+    table[static_cast<unsigned char>('T')] = 0x14;
+    table[static_cast<unsigned char>('Y')] = 0x15;
+    table[static_cast<unsigned char>('U')] = 0x16;
+    table[static_cast<unsigned char>('I')] = 0x17;
+    table[static_cast<unsigned char>('O')] = 0x18;
+    table[static_cast<unsigned char>('P')] = 0x19;
+    table[static_cast<unsigned char>('A')] = 0x1E;
+    table[static_cast<unsigned char>('S')] = 0x1F;
+    table[static_cast<unsigned char>('D')] = 0x20;
+    table[static_cast<unsigned char>('F')] = 0x21;
+    table[static_cast<unsigned char>('G')] = 0x22;
+    table[static_cast<unsigned char>('H')] = 0x23;
+    table[static_cast<unsigned char>('J')] = 0x24;
+    table[static_cast<unsigned char>('K')] = 0x25;
+    table[static_cast<unsigned char>('L')] = 0x26;
+    table[static_cast<unsigned char>('Z')] = 0x2C;
+    table[static_cast<unsigned char>('X')] = 0x2D;
+    table[static_cast<unsigned char>('C')] = 0x2E;
+    table[static_cast<unsigned char>('V')] = 0x2F;
+    table[static_cast<unsigned char>('B')] = 0x30;
+    table[static_cast<unsigned char>('N')] = 0x31;
+    table[static_cast<unsigned char>('M')] = 0x32;
+    return table;
+}();
+
+
+std::pair<std::map<std::string, std::string>, std::map<std::string, std::string>>
+VirtualPianoPlayer::define_key_mappings() {
+    auto& cfg = midi::Config::getInstance();
+    return { cfg.key_mappings["LIMITED"], cfg.key_mappings["FULL"] };
+}
+
+// ------------------------------
+// KeySequence precomputation helper
+// ------------------------------
+static KeySequence computeKeySequence(const std::string& key) {
+    KeySequence seq;
+    // Detect modifiers
+    bool hasAlt  = (key.find("alt+")  != std::string::npos);
+    bool hasCtrl = (key.find("ctrl+") != std::string::npos);
+
+    char lastChar   = key.empty() ? '\0' : key.back();
+    bool shifted    = std::isupper(static_cast<unsigned char>(lastChar)) ||
+                      std::ispunct(static_cast<unsigned char>(lastChar));
+    char lookupChar = shifted ? static_cast<char>(std::tolower(lastChar)) : lastChar;
+
+    WORD mainScan   = VirtualPianoPlayer::SCAN_TABLE_AUTO[static_cast<unsigned char>(lookupChar)];
+    constexpr WORD SHIFT_SCAN = 0x2A;
+    constexpr WORD CTRL_SCAN  = 0x1D;
+    constexpr WORD ALT_SCAN   = 0x38;
+
+    // Build press sequence
+    std::vector<INPUT> pressSeq;
+    if (shifted && mainScan != 0) {
+        INPUT input = {};
+        input.type = INPUT_KEYBOARD;
+        input.ki.wScan = mainScan;
+        input.ki.dwFlags = KEYEVENTF_SCANCODE | KEYEVENTF_KEYUP;
+        pressSeq.push_back(input);
+    }
+    if (hasAlt) {
+        INPUT input = {};
+        input.type = INPUT_KEYBOARD;
+        input.ki.wScan = ALT_SCAN;
+        input.ki.dwFlags = KEYEVENTF_SCANCODE;
+        pressSeq.push_back(input);
+    }
+    if (hasCtrl) {
+        INPUT input = {};
+        input.type = INPUT_KEYBOARD;
+        input.ki.wScan = CTRL_SCAN;
+        input.ki.dwFlags = KEYEVENTF_SCANCODE;
+        pressSeq.push_back(input);
+    }
+    if (shifted) {
+        INPUT input = {};
+        input.type = INPUT_KEYBOARD;
+        input.ki.wScan = SHIFT_SCAN;
+        input.ki.dwFlags = KEYEVENTF_SCANCODE;
+        pressSeq.push_back(input);
+    }
+    if (mainScan != 0) {
+        INPUT input = {};
+        input.type = INPUT_KEYBOARD;
+        input.ki.wScan = mainScan;
+        input.ki.dwFlags = KEYEVENTF_SCANCODE;
+        pressSeq.push_back(input);
+    }
+    if (shifted) {
+        INPUT input = {};
+        input.type = INPUT_KEYBOARD;
+        input.ki.wScan = SHIFT_SCAN;
+        input.ki.dwFlags = KEYEVENTF_SCANCODE | KEYEVENTF_KEYUP;
+        pressSeq.push_back(input);
+    }
+    if (hasCtrl) {
+        INPUT input = {};
+        input.type = INPUT_KEYBOARD;
+        input.ki.wScan = CTRL_SCAN;
+        input.ki.dwFlags = KEYEVENTF_SCANCODE | KEYEVENTF_KEYUP;
+        pressSeq.push_back(input);
+    }
+    if (hasAlt) {
+        INPUT input = {};
+        input.type = INPUT_KEYBOARD;
+        input.ki.wScan = ALT_SCAN;
+        input.ki.dwFlags = KEYEVENTF_SCANCODE | KEYEVENTF_KEYUP;
+        pressSeq.push_back(input);
+    }
+
+    // Build release sequence (simulate full tap)
+    std::vector<INPUT> releaseSeq;
+    if (hasAlt) {
+        INPUT input = {};
+        input.type = INPUT_KEYBOARD;
+        input.ki.wScan = ALT_SCAN;
+        input.ki.dwFlags = KEYEVENTF_SCANCODE;
+        releaseSeq.push_back(input);
+    }
+    if (hasCtrl) {
+        INPUT input = {};
+        input.type = INPUT_KEYBOARD;
+        input.ki.wScan = CTRL_SCAN;
+        input.ki.dwFlags = KEYEVENTF_SCANCODE;
+        releaseSeq.push_back(input);
+    }
+    if (shifted) {
+        INPUT input = {};
+        input.type = INPUT_KEYBOARD;
+        input.ki.wScan = SHIFT_SCAN;
+        input.ki.dwFlags = KEYEVENTF_SCANCODE;
+        releaseSeq.push_back(input);
+    }
+    if (mainScan != 0) {
+        INPUT input = {};
+        input.type = INPUT_KEYBOARD;
+        input.ki.wScan = mainScan;
+        input.ki.dwFlags = KEYEVENTF_SCANCODE | KEYEVENTF_KEYUP;
+        releaseSeq.push_back(input);
+    }
+    if (shifted) {
+        INPUT input = {};
+        input.type = INPUT_KEYBOARD;
+        input.ki.wScan = SHIFT_SCAN;
+        input.ki.dwFlags = KEYEVENTF_SCANCODE | KEYEVENTF_KEYUP;
+        releaseSeq.push_back(input);
+    }
+    if (hasCtrl) {
+        INPUT input = {};
+        input.type = INPUT_KEYBOARD;
+        input.ki.wScan = CTRL_SCAN;
+        input.ki.dwFlags = KEYEVENTF_SCANCODE | KEYEVENTF_KEYUP;
+        releaseSeq.push_back(input);
+    }
+    if (hasAlt) {
+        INPUT input = {};
+        input.type = INPUT_KEYBOARD;
+        input.ki.wScan = ALT_SCAN;
+        input.ki.dwFlags = KEYEVENTF_SCANCODE | KEYEVENTF_KEYUP;
+        releaseSeq.push_back(input);
+    }
+    seq.events_press   = std::move(pressSeq);
+    seq.events_release = std::move(releaseSeq);
+    return seq;
+}
+
+NoteEvent::NoteEvent() noexcept
+    : time(std::chrono::nanoseconds::zero()),
+      note(0),
+      action(EventType::Press),
+      velocity(0),
+      isSustain(false),
+      sustainValue(0),
+      trackIndex(-1),
+      coveredBy(-1)
+{}
+
+NoteEvent::NoteEvent(std::chrono::nanoseconds t,
+                     uint8_t n,
+                     EventType a,
+                     int v,
+                     bool s,
+                     int sv,
+                     int trackIdx,
+                     int covered) noexcept
+    : time(t),
+      note(n),
+      action(a),
+      velocity(v),
+      isSustain(s),
+      sustainValue(sv),
+      trackIndex(trackIdx),
+      coveredBy(covered)
+{}
+
+bool NoteEvent::operator>(const NoteEvent& other) const noexcept {
+    return time > other.time;
+}
+
+//----------------------------------------------------------------
+// NoteEventPool Implementation.
+NoteEventPool::NoteEventPool()
+    : head(nullptr),
+      current(nullptr),
+      end(nullptr),
+      allocated_count(0)
+{
+    allocateNewBlock();
+}
+
+NoteEventPool::~NoteEventPool() {
+    while (head) {
+        Block* next = head->next;
+        _aligned_free(head);
+        head = next;
+    }
+}
+
+void NoteEventPool::allocateNewBlock() {
+    Block* newBlock = static_cast<Block*>(_aligned_malloc(sizeof(Block), CACHE_LINE_SIZE));
+    if (!newBlock)
+        throw std::bad_alloc();
+    newBlock->next = head;
+    head           = newBlock;
+    current        = newBlock->data;
+    end            = current + BLOCK_SIZE;
+}
+
+void NoteEventPool::reset() {
+    current = head->data;
+    allocated_count.store(0, std::memory_order_relaxed);
+}
+
+size_t NoteEventPool::getAllocatedCount() const {
+    return allocated_count.load(std::memory_order_relaxed);
+}
+
+//----------------------------------------------------------------
+// PlaybackControl Implementation.
+void PlaybackControl::requestSkip(std::chrono::seconds amount) {
+    std::lock_guard<std::mutex> lock(mutex);
+    pending_command = Command::SKIP;
+    command_amount  = amount;
+    command_processed.store(false, std::memory_order_release);
+    SetEvent(VirtualPianoPlayer::command_event); // Signal command event
+}
+
+void PlaybackControl::requestRewind(std::chrono::seconds amount) {
+    std::lock_guard<std::mutex> lock(mutex);
+    pending_command = Command::REWIND;
+    command_amount  = amount;
+    command_processed.store(false, std::memory_order_release);
+    SetEvent(VirtualPianoPlayer::command_event); // Signal command event
+}
+
+void PlaybackControl::requestResync() {
+    std::lock_guard<std::mutex> lock(mutex);
+    pending_command = Command::RESYNC;
+    command_amount  = std::chrono::seconds(0);
+    command_processed.store(false, std::memory_order_release);
+    SetEvent(VirtualPianoPlayer::command_event); // Signal command event
+}
+
+bool PlaybackControl::hasCommand() const {
+    return (pending_command != Command::NONE) &&
+           !command_processed.load(std::memory_order_acquire);
+}
+
+PlaybackControl::State PlaybackControl::processCommand(const State& current_state,
+                                                       double speed,
+                                                       size_t /*buffer_size*/)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (command_processed.load(std::memory_order_acquire))
+        return current_state;
+
+    State new_state = current_state;
+    auto scaled = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::duration<double>(command_amount.count() * speed)
+    );
+
+    switch (pending_command) {
+    case Command::SKIP:
+        new_state.position += scaled;
+        new_state.needs_reset = true;
+        break;
+    case Command::REWIND:
+        new_state.position = (scaled > new_state.position)
+                             ? std::chrono::nanoseconds(0)
+                             : new_state.position - scaled;
+        new_state.needs_reset = true;
+        break;
+    case Command::RESYNC:
+        new_state.needs_reset = true;
+        break;
+    default:
+        break;
+    }
+
+    command_processed.store(true, std::memory_order_release);
+    pending_command = Command::NONE;
+    return new_state;
+}
+
+//----------------------------------------------------------------
+// IsWin7OrWin8_Real: Check if OS is exactly Windows 7 or 8.
+bool IsWin7OrWin8_Real() {
+    HMODULE hNtdll = GetModuleHandleA("ntdll.dll");
+    if (!hNtdll)
+        return false;
+    auto pRtlGetVersion = reinterpret_cast<RtlGetVersionPtr>(
+        GetProcAddress(hNtdll, "RtlGetVersion"));
+    if (!pRtlGetVersion)
+        return false;
+
+    RTL_OSVERSIONINFOW info = {};
+    info.dwOSVersionInfoSize = sizeof(info);
+    if (pRtlGetVersion(&info) != 0)
+        return false;
+
+    return (info.dwMajorVersion == 6 &&
+           (info.dwMinorVersion == 1 || info.dwMinorVersion == 2));
+}
+//----------------------------------------------------------------
+// VirtualPianoPlayer Implementation.
+VirtualPianoPlayer::VirtualPianoPlayer() noexcept(false)
+    : processing_pool(1)   // playback waits on each batch, so one task runs at a time
+{
+    ShowSplashScreen((HINSTANCE)GetModuleHandle(nullptr));
+
+    try {
+        midi::Config::getInstance().loadFromFile("config.json");
+    }
+    catch (const midi::ConfigException& e) {
+        std::cerr << "Configuration error: " << e.what()
+            << "\nLoading default settings...\n";
+        midi::Config::getInstance().setDefaults();
+        try {
+            midi::Config::getInstance().saveToFile("config.json");
+        }
+        catch (const midi::ConfigException& e2) {
+            std::cerr << "Failed to save default config: " << e2.what() << "\n";
+        }
+    }
+
+    if (IsWin7OrWin8_Real()) {
+        CloseSplashScreen();
+        MessageBoxA(nullptr,
+            "Incompatible OS detected.\nThis software requires Windows 8.1 or later.",
+            "Incompatibility Warning",
+            MB_ICONERROR | MB_OK);
+        throw std::runtime_error("Incompatible OS (Windows 7/8) detected");
+    }
+    TIMECAPS tc;
+    if (timeGetDevCaps(&tc, sizeof(tc)) == TIMERR_NOERROR) {
+        UINT minPeriod = std::max(1U, tc.wPeriodMin);
+        if (timeBeginPeriod(minPeriod) == TIMERR_NOERROR) {
+            m_timerResolutionSet = minPeriod;
+        }
+    }
+    auto mappings = define_key_mappings();
+    limited_key_mappings = std::move(mappings.first);
+    full_key_mappings = std::move(mappings.second);
+    dispatch_batch.reserve(256);
+    batch_events.reserve(256);
+    waitable_timer = CreateWaitableTimerEx(
+        nullptr,
+        nullptr,
+        CREATE_WAITABLE_TIMER_HIGH_RESOLUTION,
+        TIMER_ALL_ACCESS
+    );
+    if (!waitable_timer) {
+        waitable_timer = CreateWaitableTimer(nullptr, FALSE, nullptr);
+        if (!waitable_timer) {
+            CloseSplashScreen();
+            throw std::runtime_error("Failed to create waitable timer");
+        }
+    }
+    command_event = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+    if (!command_event) {
+        CloseHandle(waitable_timer);
+        CloseSplashScreen();
+        throw std::runtime_error("Failed to create command event");
+    }
+    try {
+        sustain_key_code = stringToVK(midi::Config::getInstance().hotkeys.SUSTAIN_KEY);
+        volume_up_key_code = vkToScanCode(stringToVK(midi::Config::getInstance().hotkeys.VOLUME_UP_KEY));
+        volume_down_key_code = vkToScanCode(stringToVK(midi::Config::getInstance().hotkeys.VOLUME_DOWN_KEY));
+    }
+    catch (const std::exception& e) {
+        CloseSplashScreen();
+        throw std::runtime_error(std::string("Error mapping hotkeys: ") + e.what());
+    }
+
+    if (sustain_key_code == 0 || volume_up_key_code == 0 || volume_down_key_code == 0) {
+        CloseSplashScreen();
+        throw std::runtime_error("Invalid hotkey configuration. Check your config file.");
+    }
+
+    // 8) Start hotkey listener thread
+    hotkey_thread = std::make_unique<std::jthread>(&VirtualPianoPlayer::hotkey_listener, this);
+
+    // 9) Initialize RDTSC-based timer
+    rdtsc_timer_init();
+    if (rdtsc_timer_status() != RDTSC_TIMER_READY) {
+        CloseSplashScreen();
+        throw std::runtime_error("High-res TSC timer not available or calibration failed.");
+    }
+
+    double freq = rdtsc_timer_get_frequency(); // in Hz
+    if (freq <= 1e5) { // sanity check
+        CloseSplashScreen();
+        throw std::runtime_error("Measured TSC frequency is too low or invalid.");
+    }
+
+    // Convert cycles -> nanoseconds. Combine with current_speed
+    cyclesToNs = 1.0e9 / freq;
+    time_factor = cyclesToNs * current_speed;
+
+    SyscallNumber = GetNtUserSendInputSyscallNumber();
+    InitializeNtUserSendInputCall();
+    initializeKeyCache();
+    CloseSplashScreen();
+}
+
+VirtualPianoPlayer::~VirtualPianoPlayer() {
+    // The producer writes into event_pool, which is destroyed before schedule_thread.
+    stop_schedule();
+
+    // Stop playback thread.
+    should_stop.store(true, std::memory_order_release);
+    signalPlayback();
+    if (playback_thread && playback_thread->joinable()) {
+        playback_thread->join();
+    }
+    // The pedal is ours once the playback thread (and its injector) are gone.
+    if (isSustainPressed) {
+        releaseKey(sustain_key_code);
+        isSustainPressed = false;
+    }
+
+    if (command_event) {
+        CloseHandle(command_event);
+    }
+
+    if (waitable_timer) {
+        CloseHandle(waitable_timer);
+    }
+
+    if (m_timerResolutionSet != 0) {
+        timeEndPeriod(m_timerResolutionSet);
+        m_timerResolutionSet = 0;
+    }
+
+    // Now stop the hotkey thread.
+    hotkey_stop.store(true, std::memory_order_release);
+    if (hotkey_thread && hotkey_thread->joinable()) {
+        hotkey_thread->join();
+    }
+}
+
+std::chrono::nanoseconds VirtualPianoPlayer::get_adjusted_time() noexcept {
+    // If paused, just return the last total time
+    if (paused.load(std::memory_order_relaxed))
+        return total_adjusted_time;
+    uint64_t current_tsc = __rdtsc();
+    uint64_t tick_diff   = current_tsc - last_resume_tsc;
+
+    // (tick_diff) TSC cycles * cyclesToNs => nanoseconds
+    // We also scale by current_speed
+    double rawNs = double(tick_diff) * cyclesToNs * current_speed;
+    auto adjusted_ns = static_cast<std::chrono::nanoseconds::rep>(rawNs + 0.5);
+
+    return total_adjusted_time + std::chrono::nanoseconds(adjusted_ns);
+}
+
+void VirtualPianoPlayer::wait_for_schedule(std::chrono::nanoseconds target) {
+    // Blocks until the producer has merged every event up to `target`.
+    auto ready = [&]() {
+        return schedule_done.load(std::memory_order_acquire) ||
+               should_stop.load(std::memory_order_acquire) ||
+               schedule_horizon_ns.load(std::memory_order_acquire) >= target.count();
+    };
+    std::unique_lock<std::mutex> lock(schedule_mutex);
+    // should_stop is signalled through playback_cv, so poll rather than rely on a notify.
+    while (!schedule_cv.wait_for(lock, std::chrono::milliseconds(5), ready)) {}
+}
+
+bool VirtualPianoPlayer::playback_reached_end() const noexcept {
+    return schedule_done.load(std::memory_order_acquire) &&
+           buffer_index.load(std::memory_order_acquire) >= scheduled_count.load(std::memory_order_acquire);
+}
+
+void VirtualPianoPlayer::play_notes() {
+    // Don't start the clock until the first few seconds are scheduled.
+    wait_for_schedule(SCHEDULE_PRIME_WINDOW);
+
+    // Enable MMCSS for low-latency pro audio.
+    DWORD taskIndex = 0;
+    HANDLE mmcss_handle = AvSetMmThreadCharacteristics(L"Pro Audio", &taskIndex);
+    if (mmcss_handle) {
+        AvSetMmThreadPriority(mmcss_handle, AVRT_PRIORITY_CRITICAL);
+    }
+
+    if (!dispatch::modeFromName(midi::Config::getInstance().autoplayer_timing.DISPATCH_MODE, dispatch_mode))
+        dispatch_mode = dispatch::Mode::Inline;
+    if (dispatch_mode == dispatch::Mode::Injector)
+        start_injector();
+
+    // Options toggled during the last run are compiled in before this one starts.
+    refresh_program();
+
+    const auto& timingCfg = midi::Config::getInstance().autoplayer_timing;
+    if (!timing::profileFromName(timingCfg.LATENCY_PROFILE, latency_profile))
+        latency_profile = timing::Profile::Balanced;
+    spin_guard = timingCfg.SPIN_GUARD_US >= 0 ? std::chrono::microseconds(timingCfg.SPIN_GUARD_US)
+                                              : timing::guardBand(latency_profile);
+    input_batch_cap = static_cast<size_t>(timingCfg.INPUT_BATCH_CAP);
+
+    if (!playback_started.load(std::memory_order_acquire)) {
+        playback_started.store(true, std::memory_order_release);
+        uint64_t now_tsc = __rdtsc();
+        playback_start_time = now_tsc;
+        last_resume_tsc     = now_tsc;
+    }
+
+    size_t buffer_size   = scheduled_events();
+    size_t current_index = buffer_index.load(std::memory_order_acquire);
+
+    // Auto-transpose logic if enabled
+    if (midi::Config::getInstance().auto_transpose.ENABLED &&
+        [this]() {
+            int suggestedTransposition = toggle_transpose_adjustment();
+            int diff = suggestedTransposition - currentTransposition;
+            if (diff) {
+                std::cout << "Suggested Transposition: " << suggestedTransposition
+                          << "\n[Transpose] Adjusting by " << diff << " steps.\n";
+                [&]() -> bool {
+                    auto& cfg = midi::Config::getInstance().auto_transpose;
+                    WORD scanCode = MapVirtualKey(
+                        stringToVK(diff > 0 ? cfg.TRANSPOSE_UP_KEY
+                                            : cfg.TRANSPOSE_DOWN_KEY),
+                        MAPVK_VK_TO_VSC
+                    );
+                    int steps = std::abs(diff);
+                    // sleep before arrowsend to fix off-by-1 error
+                    for (int i = 0; i < steps; ++i) {
+                        Sleep(50);
+                        arrowsend(scanCode, true);
+                    }
+                    currentTransposition = suggestedTransposition;
+                    return true;
+                }();
+                return true;
+            }
+            return false;
+        }());
+
+    while (!should_stop.load(std::memory_order_acquire)) {
+        auto current_time = get_adjusted_time();
+        buffer_size = scheduled_events();
+
+        // Process any pending command events
+        if (WaitForSingleObject(command_event, 0) == WAIT_OBJECT_0) {
+            // While parked, reprocess_schedule may be rebuilding note_buffer under reprocess_mutex.
+            std::unique_lock<std::mutex> rebuild(reprocess_mutex, std::defer_lock);
+            if (playback_parked.load()) {
+                rebuild.lock();
+                buffer_size = scheduled_events();
+            }
+            auto new_state = playback_control.processCommand(
+                { current_time, current_index, false },
+                current_speed,
+                buffer_size
+            );
+            if (new_state.needs_reset) {
+                current_index = find_next_event_index(new_state.position);
+                buffer_index.store(current_index, std::memory_order_release);
+                total_adjusted_time = new_state.position;
+                last_resume_tsc     = __rdtsc();
+            }
+            ResetEvent(command_event);
+        }
+
+        // If paused, held or at end, wait until resumed or commanded
+        if (dispatch_stopped() || current_index >= buffer_size) {
+            if (dispatch_stopped() && !playback_parked.load()) {
+                playback_parked.store(true);
+                playback_cv.notify_all();
+            }
+            std::unique_lock<std::mutex> lock(playback_cv_mutex);
+            playback_cv.wait_for(lock,
+                                 std::chrono::milliseconds(5),
+                                 [this]() {
+                return !dispatch_stopped() ||
+                        should_stop.load() ||
+                       (WaitForSingleObject(command_event, 0) == WAIT_OBJECT_0);
+            });
+            continue;
+        }
+        if (playback_parked.load()) {
+            // Unpark before touching note_buffer, then recheck: a pause or hold may have seen us parked.
+            playback_parked.store(false);
+            if (dispatch_stopped())
+                continue;
+        }
+
+        auto next_event_time = note_buffer[current_index]->time;
+        current_time = get_adjusted_time();
+
+        if (next_event_time > current_time) {
+            wait_for_event(next_event_time - current_time);
+            continue;
+        }
+
+        // Process all events that are due
+        current_time = get_adjusted_time();
+        buffer_size  = scheduled_events();
+        size_t due_end = current_index;
+        while (due_end < buffer_size &&
+               note_buffer[due_end]->time <= current_time)
+        {
+            ++due_end;
+        }
+
+        dispatch_batch.clear();
+        if (!collect_program_steps(current_index, due_end)) {
+            // We release notes first, then press new ones
+            for (size_t i = current_index; i < due_end; ++i) {
+                if (note_buffer[i]->action == EventType::Release)
+                    dispatch_batch.push_back(note_buffer[i]);
+            }
+            for (size_t i = current_index; i < due_end; ++i) {
+                if (note_buffer[i]->action == EventType::Press)
+                    dispatch_batch.push_back(note_buffer[i]);
+            }
+        }
+        current_index = due_end;
+        buffer_index.store(current_index, std::memory_order_release);
+
+        if (!dispatch_steps.empty() || !dispatch_batch.empty()) {
+            dispatch_due_events(__rdtsc());
+        }
+    }
+
+    stop_injector();
+    if (mmcss_handle) {
+        AvRevertMmThreadCharacteristics(mmcss_handle);
+    }
+    playback_parked.store(true);
+    playback_cv.notify_all();
+}
+
+bool VirtualPianoPlayer::wait_until_parked() {
+    // Pairs with the playback thread's unpark-then-recheck of paused.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    signalPlayback();
+    // The playback thread parks at its next loop turn; poll in case the notify is missed.
+    std::unique_lock<std::mutex> lock(playback_cv_mutex);
+    while (!playback_cv.wait_for(lock, std::chrono::milliseconds(1), [this]() {
+        return playback_parked.load() || !dispatch_stopped();
+    })) {}
+    return playback_parked.load();
+}
+
+VirtualPianoPlayer::DispatchHold::DispatchHold(VirtualPianoPlayer& owner)
+    : player(owner), serialize(owner.dispatch_hold_mutex) {
+    player.dispatch_holds.fetch_add(1);
+    player.wait_until_parked();
+    // Parked, so nothing more is queued; let the injector finish what was.
+    player.drain_injector();
+}
+
+VirtualPianoPlayer::DispatchHold::~DispatchHold() {
+    player.dispatch_holds.fetch_sub(1);
+    player.signalPlayback();
+}
+
+void VirtualPianoPlayer::wait_for_event(std::chrono::nanoseconds song_wait) {
+    // Song time runs current_speed times as fast as the wall clock.
+    const double wall_ns = double(song_wait.count()) / current_speed;
+    const uint64_t deadline_tsc = __rdtsc() + static_cast<uint64_t>(wall_ns / cyclesToNs);
+
+    const double sleep_ns = wall_ns - double(spin_guard.count());
+    if (sleep_ns > 0.0) {
+        // Relative due time, in 100 ns units.
+        LARGE_INTEGER due;
+        due.QuadPart = -std::max<LONGLONG>(1, static_cast<LONGLONG>(sleep_ns / 100.0));
+        if (SetWaitableTimer(waitable_timer, &due, 0, nullptr, nullptr, FALSE)) {
+            // Every command, pause and stop sets command_event.
+            HANDLE handles[] = { command_event, waitable_timer };
+            if (WaitForMultipleObjects(2, handles, FALSE, INFINITE) != WAIT_OBJECT_0 + 1) {
+                CancelWaitableTimer(waitable_timer);
+                return;
+            }
+        }
+        else {
+            // No timer: sleep on the condition variable, then spin the guard band like the timer path.
+            std::unique_lock<std::mutex> lock(playback_cv_mutex);
+            if (playback_cv.wait_for(lock,
+                                     std::chrono::nanoseconds(static_cast<int64_t>(sleep_ns)),
+                                     [this]() {
+                    return dispatch_stopped() || should_stop.load();
+                }))
+                return;
+        }
+    }
+
+    // Inside the guard band: spin on the TSC. A command waits at most the band.
+    while (__rdtsc() < deadline_tsc) {
+        if (dispatch_stopped() || should_stop.load(std::memory_order_relaxed))
+            return;
+        _mm_pause();
+    }
+}
+
+void VirtualPianoPlayer::dispatch_due_events(uint64_t ready_tsc) {
+    const DispatchClock clock{ get_adjusted_time(), current_speed, __rdtsc() };
+    switch (dispatch_mode) {
+    case dispatch::Mode::Inline:
+        dispatch_latency.record(__rdtsc() - ready_tsc);
+        run_dispatch_batch(clock);
+        break;
+    case dispatch::Mode::Injector: {
+        const bool compiled = !dispatch_steps.empty();
+        const size_t count = compiled ? dispatch_steps.size() : dispatch_batch.size();
+        // Counted before the push so drain_injector never sees the injector ahead.
+        inject_queued.store(inject_queued.load(std::memory_order_relaxed) + count, std::memory_order_relaxed);
+        for (size_t i = 0; i < count; ++i) {
+            const InjectItem item{ compiled ? nullptr : dispatch_batch[i],
+                                   compiled ? dispatch_steps[i] : nullptr,
+                                   i == 0 ? ready_tsc : 0, clock, i + 1 == count };
+            // Full only if the injector is over 4096 events behind; it is awake then.
+            while (!inject_ring->push(item))
+                std::this_thread::yield();
+        }
+        inject_signal.fetch_add(1, std::memory_order_release);
+        inject_signal.notify_one();
+        break;
+    }
+    case dispatch::Mode::Pool:
+        processing_pool.enqueue([this, ready_tsc, clock]() {
+            dispatch_latency.record(__rdtsc() - ready_tsc);
+            run_dispatch_batch(clock);
+        }).get();
+        break;
+    }
+}
+
+void VirtualPianoPlayer::run_dispatch_batch(const DispatchClock& clock) noexcept {
+    begin_input_batch(clock);
+    if (!dispatch_steps.empty()) {
+        for (const PlaybackProgram::Step* step : dispatch_steps)
+            run_program_step(*step);
+    }
+    else {
+        for (const NoteEvent* e : dispatch_batch)
+            inject_event(*e);
+    }
+    end_input_batch();
+}
+
+void VirtualPianoPlayer::begin_input_batch(const DispatchClock& clock) noexcept {
+    batch_clock = clock;
+    batch_events.clear();
+    InputGather& g = t_gather;
+    g.active = true;
+    g.cap = input_batch_cap;
+    if (g.pending.capacity() < g.cap) {
+        try {
+            g.pending.reserve(g.cap);
+        }
+        catch (const std::bad_alloc&) {
+            g.cap = 0;
+        }
+    }
+    g.calls = 0;
+    g.sequences = 0;
+}
+
+void VirtualPianoPlayer::end_input_batch() noexcept {
+    InputGather& g = t_gather;
+    // The batch counts as emitted as its last SendInput call starts: after the handoff,
+    // the injector's wake-up and any calls the cap already made.
+    const uint64_t sendTsc = __rdtsc();
+    flushInputs(g);
+    g.active = false;
+    if (g.calls)
+        input_calls.record(g.calls, g.sequences, g.lastTsc - g.firstTsc);
+
+    const double sinceDispatchNs = double(sendTsc - batch_clock.tsc) * cyclesToNs;
+    for (const NoteEvent* e : batch_events) {
+        const double late = double((batch_clock.now - e->time).count()) / batch_clock.speed + sinceDispatchNs;
+        event_lateness.record(static_cast<int64_t>(late), e->time.count(), e->note, e->trackIndex);
+    }
+    batch_events.clear();
+}
+
+void VirtualPianoPlayer::note_batch_event(const NoteEvent& event) noexcept {
+    try {
+        batch_events.push_back(&event);
+    }
+    catch (const std::bad_alloc&) {
+        // Out of memory: time this one as it is queued rather than lose it.
+        event_lateness.record(static_cast<int64_t>(double((batch_clock.now - event.time).count()) / batch_clock.speed),
+                              event.time.count(), event.note, event.trackIndex);
+    }
+}
+
+void VirtualPianoPlayer::inject_event(const NoteEvent& event) noexcept {
+    note_batch_event(event);
+    execute_note_event(event);
+}
+
+bool VirtualPianoPlayer::collect_program_steps(size_t first, size_t last) {
+    dispatch_steps.clear();
+    if (first == last)
+        return false;
+
+    const uint32_t version = program_version.load(std::memory_order_acquire);
+    if (version != active_program_version) {
+        // Steps still queued to the injector point into the old program.
+        drain_injector();
+        active_program = program.load(std::memory_order_acquire);
+        active_program_version = version;
+        program_cursor = 0;
+        track_state_seen = track_state_version.load(std::memory_order_relaxed) - 1;
+    }
+    const PlaybackProgram* prog = active_program.get();
+    // Volume arrows follow the game's volume, which no replay can know ahead.
+    if (!prog || enable_volume_adjustment.load(std::memory_order_relaxed) ||
+        !(prog->options == current_program_options()))
+        return false;
+
+    const uint32_t trackState = track_state_version.load(std::memory_order_relaxed);
+    if (trackState != track_state_seen) {
+        track_state_seen = trackState;
+        disabled_tracks = 0;
+        for (size_t t = 0; t < trackMuted.size(); ++t) {
+            if (!isTrackEnabled(static_cast<int>(t)))
+                disabled_tracks |= uint64_t(1) << (t & 63);
+        }
+    }
+
+    if (program_cursor >= prog->steps.size() || prog->steps[program_cursor].firstEvent != first)
+        program_cursor = prog->stepAt(first);
+    size_t s = program_cursor;
+    for (size_t next = first; next < last; ++s) {
+        if (s >= prog->steps.size() || prog->steps[s].firstEvent != next ||
+            (prog->steps[s].trackMask & disabled_tracks) != 0) {
+            dispatch_steps.clear();
+            return false;
+        }
+        dispatch_steps.push_back(&prog->steps[s]);
+        next += prog->steps[s].eventCount;
+    }
+    program_cursor = s;
+    return true;
+}
+
+void VirtualPianoPlayer::run_program_step(const PlaybackProgram::Step& step) noexcept {
+    const PlaybackProgram& prog = *active_program;
+    // A key index of an older program means nothing in this one.
+    if (velocity_key_version != active_program_version) {
+        velocity_key_version = active_program_version;
+        program_velocity_key = -1;
+    }
+    // The step assumes the pedal and velocity key its replay had reached. A seek or
+    // steps played event by event can leave them elsewhere, so put them right first.
+    if (isSustainPressed != step.sustainBefore) {
+        sendVirtualKey(sustain_key_code, step.sustainBefore);
+        isSustainPressed = step.sustainBefore;
+    }
+    if (step.velocityKeyBefore >= 0 && program_velocity_key != step.velocityKeyBefore) {
+        const std::string& name = prog.velocityKeys[step.velocityKeyBefore];
+        if (lastPressedKey != name) {
+            const auto& tap = prog.velocityTaps[step.velocityKeyBefore];
+            sendInputs(tap.data(), tap.size());
+            lastPressedKey = name;
+        }
+        program_velocity_key = step.velocityKeyBefore;
+    }
+
+    for (uint32_t i = 0; i < step.eventCount; ++i)
+        note_batch_event(*note_buffer[step.firstEvent + i]);
+    sendInputs(prog.inputs.data() + step.firstInput, step.inputCount);
+    const auto& noteKeys = prog.options.fullKeys ? g_fullNoteKeys : g_limitedNoteKeys;
+    for (uint32_t i = 0; i < step.keyOpCount; ++i) {
+        const PlaybackProgram::KeyOp op = prog.keyOps[step.firstKeyOp + i];
+        // The source may be held on a key chosen event by event under other options.
+        lift_held_key(op.source, noteKeys[op.note]);
+        pressed_notes[op.note].store(op.press, std::memory_order_relaxed);
+        if (op.press) {
+            held_keys[op.source].store(op.note, std::memory_order_relaxed);
+            held_sequences[op.source].store(noteKeys[op.note], std::memory_order_relaxed);
+        }
+    }
+
+    const size_t index = static_cast<size_t>(&step - prog.steps.data());
+    isSustainPressed = prog.sustainAfter(index);
+    const int16_t key = prog.velocityKeyAfter(index);
+    if (key >= 0 && key != program_velocity_key) {
+        lastPressedKey = prog.velocityKeys[key];
+        program_velocity_key = key;
+    }
+}
+
+void VirtualPianoPlayer::start_injector() {
+    if (!inject_ring)
+        inject_ring = std::make_unique<dispatch::SpscRing<InjectItem, 4096>>();
+    inject_queued.store(0, std::memory_order_relaxed);
+    inject_done.store(0, std::memory_order_relaxed);
+    injector_thread = std::make_unique<std::jthread>(
+        [this](std::stop_token stop) { run_injector(stop); }
+    );
+}
+
+void VirtualPianoPlayer::stop_injector() {
+    if (!injector_thread)
+        return;
+    drain_injector();
+    injector_thread->request_stop();
+    inject_signal.fetch_add(1, std::memory_order_release);
+    inject_signal.notify_one();
+    injector_thread->join();
+    injector_thread.reset();
+}
+
+void VirtualPianoPlayer::run_injector(std::stop_token stop) {
+    const unsigned processors = std::max(1u, std::thread::hardware_concurrency());
+    const int configured = midi::Config::getInstance().autoplayer_timing.INJECTOR_CPU;
+    const unsigned cpu = configured < 0 ? processors - 1 : static_cast<unsigned>(configured);
+    if (cpu >= processors || !SetThreadAffinityMask(GetCurrentThread(), static_cast<DWORD_PTR>(1) << cpu))
+        std::cerr << "[Dispatch] Could not pin the injector to CPU " << cpu << "; it runs unpinned.\n";
+
+    DWORD taskIndex = 0;
+    HANDLE mmcss_handle = AvSetMmThreadCharacteristics(L"Pro Audio", &taskIndex);
+    if (mmcss_handle) {
+        AvSetMmThreadPriority(mmcss_handle, AVRT_PRIORITY_CRITICAL);
+    }
+
+    // Spin this many pauses for the next chord before sleeping on inject_signal.
+    constexpr int SPIN_LIMIT = 4096;
+    InjectItem item{};
+    int spins = 0;
+    for (;;) {
+        // Read the signal before looking at the ring, so a push after the look still wakes us.
+        const uint32_t signal = inject_signal.load(std::memory_order_acquire);
+        if (inject_ring->pop(item)) {
+            if (item.readyTsc) {
+                dispatch_latency.record(__rdtsc() - item.readyTsc);
+                begin_input_batch(item.clock);
+            }
+            if (item.step)
+                run_program_step(*item.step);
+            else
+                inject_event(*item.event);
+            // The rest of the batch was pushed with its first item, so it is moments away.
+            if (item.batchEnd)
+                end_input_batch();
+            inject_done.store(inject_done.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+            spins = 0;
+            continue;
+        }
+        if (stop.stop_requested())
+            break;
+        if (++spins < SPIN_LIMIT) {
+            _mm_pause();
+            continue;
+        }
+        inject_signal.wait(signal, std::memory_order_acquire);
+        spins = 0;
+    }
+
+    if (mmcss_handle) {
+        AvRevertMmThreadCharacteristics(mmcss_handle);
+    }
+}
+
+void VirtualPianoPlayer::drain_injector() noexcept {
+    while (inject_done.load(std::memory_order_acquire) != inject_queued.load(std::memory_order_relaxed))
+        std::this_thread::yield();
+}
+
+void VirtualPianoPlayer::report_dispatch_latency() {
+    const uint64_t batches = dispatch_latency.batches.load(std::memory_order_relaxed);
+    if (batches == 0)
+        return;
+    const double meanUs = double(dispatch_latency.totalTicks.load(std::memory_order_relaxed)) / batches * cyclesToNs / 1000.0;
+    const double maxUs  = double(dispatch_latency.maxTicks.load(std::memory_order_relaxed)) * cyclesToNs / 1000.0;
+    std::cout << "[Dispatch] " << dispatch::modeName(dispatch_mode) << ": " << batches
+              << " batches, handoff mean " << std::fixed << std::setprecision(2) << meanUs
+              << " us, max " << maxUs << " us\n";
+    dispatch_latency.reset();
+
+    const uint64_t inputBatches = input_calls.batches.load(std::memory_order_relaxed);
+    if (inputBatches == 0)
+        return;
+    const uint64_t calls     = input_calls.calls.load(std::memory_order_relaxed);
+    const uint64_t sequences = input_calls.sequences.load(std::memory_order_relaxed);
+    const double spreadUs    = double(input_calls.spreadTicks.load(std::memory_order_relaxed)) / inputBatches * cyclesToNs / 1000.0;
+    const double maxSpreadUs = double(input_calls.maxSpreadTicks.load(std::memory_order_relaxed)) * cyclesToNs / 1000.0;
+    std::cout << "[Dispatch] SendInput (cap " << input_batch_cap << "): " << calls << " calls for "
+              << sequences << " key sequences, " << double(calls) / inputBatches << " per batch; chord spread mean "
+              << spreadUs << " us, max " << maxSpreadUs << " us\n";
+    input_calls.reset();
+}
+
+// m:ss.mmm of a song position.
+static std::string format_song_position(int64_t ns) {
+    const int64_t ms = std::max<int64_t>(ns, 0) / 1'000'000;
+    std::ostringstream out;
+    out << ms / 60000 << ':' << std::setfill('0') << std::setw(2) << (ms / 1000) % 60
+        << '.' << std::setw(3) << ms % 1000;
+    return out.str();
+}
+
+void VirtualPianoPlayer::report_event_lateness() {
+    using timing::LatenessHistogram;
+    const uint64_t events = event_lateness.count();
+    if (events == 0)
+        return;
+    auto us = [](int64_t ns) { return double(ns) / 1000.0; };
+    const uint64_t overTarget = event_lateness.countAbove(LatenessHistogram::TARGET_NS);
+    const uint64_t overLate   = event_lateness.countAbove(LatenessHistogram::LATE_NS);
+    const auto worst = event_lateness.worst();
+
+    std::cout << "[Timing] " << timing::profileName(latency_profile) << " (spin "
+              << std::chrono::duration_cast<std::chrono::microseconds>(spin_guard).count() << " us): "
+              << events << " events late by p50 " << std::fixed << std::setprecision(1)
+              << us(event_lateness.percentileNs(0.5)) << " us, p99 " << us(event_lateness.percentileNs(0.99))
+              << " us, p99.9 " << us(event_lateness.percentileNs(0.999)) << " us, max "
+              << us(event_lateness.maxNs()) << " us; " << overTarget << " over "
+              << LatenessHistogram::TARGET_NS / 1000 << " us, " << overLate << " over "
+              << LatenessHistogram::LATE_NS / 1'000'000 << " ms\n";
+    for (size_t i = 0; i < std::min<size_t>(worst.size(), 3); ++i) {
+        std::cout << "[Timing]   " << us(worst[i].lateNs) << " us late at "
+                  << format_song_position(worst[i].songNs) << " (note " << worst[i].note
+                  << ", track " << worst[i].track << ")\n";
+    }
+
+    if (midi::Config::getInstance().autoplayer_timing.LATENESS_DUMP) {
+        nlohmann::json dump{
+            {"profile", timing::profileName(latency_profile)},
+            {"dispatch", dispatch::modeName(dispatch_mode)},
+            {"spin_guard_us", std::chrono::duration_cast<std::chrono::microseconds>(spin_guard).count()},
+            {"events", events},
+            {"mean_us", event_lateness.meanNs() / 1000.0},
+            {"p50_us", us(event_lateness.percentileNs(0.5))},
+            {"p99_us", us(event_lateness.percentileNs(0.99))},
+            {"p999_us", us(event_lateness.percentileNs(0.999))},
+            {"max_us", us(event_lateness.maxNs())},
+            {"over_target", overTarget},
+            {"target_us", LatenessHistogram::TARGET_NS / 1000},
+            {"over_late", overLate},
+            {"late_threshold_us", LatenessHistogram::LATE_NS / 1000},
+            {"worst", nlohmann::json::array()},
+            {"histogram_ns", nlohmann::json::array()}
+        };
+        for (const auto& w : worst) {
+            dump["worst"].push_back({
+                {"late_us", us(w.lateNs)},
+                {"song_position", format_song_position(w.songNs)},
+                {"song_ns", w.songNs},
+                {"note", w.note},
+                {"track", w.track}
+            });
+        }
+        // [bucket upper bound, events] for every non-empty bucket.
+        for (const auto& [upper, n] : event_lateness.buckets())
+            dump["histogram_ns"].push_back({ upper, n });
+        std::ofstream file("lateness.json");
+        if (file << dump.dump(4))
+            std::cout << "[Timing] Wrote lateness.json\n";
+        else
+            std::cerr << "[Timing] Could not write lateness.json\n";
+    }
+    event_lateness.reset();
+}
+
+size_t VirtualPianoPlayer::find_next_event_index(const std::chrono::nanoseconds& target_time) {
+    // A seek past the produced horizon waits for the producer to get there.
+    wait_for_schedule(target_time);
+    NoteEvent* const* first = note_buffer.get();
+    auto it = std::lower_bound(first,
+                               first + scheduled_events(),
+                               target_time,
+                               [](const NoteEvent* e, const std::chrono::nanoseconds& t) {
+                                   return e->time < t;
+                               });
+    return static_cast<size_t>(it - first);
+}
+
+void VirtualPianoPlayer::toggleSustainMode() {
+    DispatchHold hold(*this);
+    switch (currentSustainMode) {
+    case SustainMode::IG:
+        currentSustainMode = SustainMode::SPACE_DOWN;
+        std::cout << "[SUSTAIN] DOWN cutoff=" << g_sustainCutoff << "\n";
+        break;
+    case SustainMode::SPACE_DOWN:
+        currentSustainMode = SustainMode::SPACE_UP;
+        std::cout << "[SUSTAIN] UP (inverted) cutoff=" << g_sustainCutoff << "\n";
+        break;
+    case SustainMode::SPACE_UP:
+        currentSustainMode = SustainMode::IG;
+        std::cout << "[SUSTAIN] IGNORE\n";
+        if (isSustainPressed) {
+            releaseKey(sustain_key_code);
+            isSustainPressed = false;
+        }
+        break;
+    }
+}
+
+void VirtualPianoPlayer::cycle_note_handling_mode() {
+    using NH = midi::NoteHandlingMode;
+    auto& mode = midi::Config::getInstance().playback.noteHandlingMode;
+    mode = (mode == NH::NoHandling) ? NH::FIFO : (mode == NH::FIFO) ? NH::LIFO : NH::NoHandling;
+    std::cout << "[NOTE MODE] " << midi::Config::noteHandlingModeToString(mode) << "\n";
+    reprocess_schedule();
+}
+
+void VirtualPianoPlayer::toggle_drum_detection() {
+    auto& settings = midi::Config::getInstance().midi;
+    settings.DETECT_DRUMS = !settings.DETECT_DRUMS;
+    std::cout << "[DRUMS] Detection " << (settings.DETECT_DRUMS ? "ON" : "OFF") << "\n";
+    reprocess_schedule();
+}
+
+void VirtualPianoPlayer::release_all_keys() {
+    DispatchHold hold(*this);
+    if (isSustainPressed) {
+        releaseKey(sustain_key_code);
+        isSustainPressed = false;
+    }
+    const auto& mappings = (eightyEightKeyModeActive ? full_key_mappings
+                                                     : limited_key_mappings);
+    for (const auto& [note, key] : mappings) {
+        KeyPress(key, false);
+    }
+    for (auto& state : pressed_notes) {
+        state.store(false, std::memory_order_relaxed);
+    }
+    for (auto& held : held_sequences) {
+        held.store(nullptr, std::memory_order_relaxed);
+    }
+    // Release alt/ctrl if pressed
+    releaseKey(VK_MENU);
+    releaseKey(VK_CONTROL);
+}
+
+void VirtualPianoPlayer::reset_volume() {
+    int diff  = midi::Config::getInstance().volume.INITIAL_VOLUME -
+                current_volume.load(std::memory_order_relaxed);
+    int steps = std::abs(diff) /
+                midi::Config::getInstance().volume.VOLUME_STEP;
+    WORD sc   = (diff > 0) ? volume_up_key_code : volume_down_key_code;
+    for (int i = 0; i < steps; ++i) {
+        arrowsend(sc, true);
+    }
+    current_volume.store(midi::Config::getInstance().volume.INITIAL_VOLUME,
+                         std::memory_order_relaxed);
+}
+
+void VirtualPianoPlayer::restart_song() {
+    try {
+        should_stop.store(true, std::memory_order_release);
+        signalPlayback();
+        if (playback_thread && playback_thread->joinable()) {
+            playback_thread->join();
+        }
+        processing_pool.clear_tasks();
+        playback_started.store(false, std::memory_order_release);
+        paused.store(false, std::memory_order_release);
+
+        constexpr auto initialBuffer = std::chrono::milliseconds(50);
+        total_adjusted_time = -initialBuffer;
+        current_speed       = 1.0;
+        buffer_index.store(0, std::memory_order_release);
+        release_all_keys();
+
+        uint64_t now_tsc = __rdtsc();
+        playback_start_time = now_tsc;
+        last_resume_tsc     = now_tsc;
+
+        should_stop.store(false, std::memory_order_release);
+        playback_parked.store(false);
+        playback_thread = std::make_unique<std::jthread>(
+            &VirtualPianoPlayer::play_notes, this
+        );
+        std::cout << "[RESTART] Done.\n";
+    }
+    catch (const std::exception& e) {
+        std::cerr << "[RESTART] Error: " << e.what() << "\n";
+    }
+}
+
+void VirtualPianoPlayer::KeyPress(std::string_view key, bool press) {
+    std::string keyStr(key);
+    auto it = g_keyCache.find(keyStr);
+    if (it == g_keyCache.end()) {
+        KeySequence seq = computeKeySequence(keyStr);
+        it = g_keyCache.emplace(std::move(keyStr), std::move(seq)).first;
+    }
+    sendKeySequence(it->second, press);
+}
+
+int VirtualPianoPlayer::stringToVK(std::string_view keyName) {
+    static const std::unordered_map<std::string, int> keyMap = {
+        {"ENTER", VK_RETURN}, {"ESC", VK_ESCAPE}, {"SPACE", VK_SPACE},
+        {"UP", VK_UP}, {"DOWN", VK_DOWN}, {"LEFT", VK_LEFT}, {"RIGHT", VK_RIGHT},
+        {"CAPS", VK_CAPITAL}, {"SHIFT", VK_SHIFT}, {"CTRL", VK_CONTROL},
+        {"ALT", VK_MENU}, {"TAB", VK_TAB}, {"F1", VK_F1}, {"F2", VK_F2},
+        {"F3", VK_F3}, {"F4", VK_F4}, {"F5", VK_F5}, {"F6", VK_F6},
+        {"F7", VK_F7}, {"F8", VK_F8}, {"F9", VK_F9}, {"F10", VK_F10},
+        {"F11", VK_F11}, {"F12", VK_F12}, {"PAUSE", VK_PAUSE},
+        {"BACK", VK_BACK}, {"DELETE", VK_DELETE}, {"HOME", VK_HOME},
+        {"END", VK_END}, {"INSERT", VK_INSERT}, {"PGUP", VK_PRIOR},
+        {"PGDN", VK_NEXT}, {"NUMLOCK", VK_NUMLOCK}, {"SCROLL", VK_SCROLL},
+        {"PRTSC", VK_SNAPSHOT}, {"APPS", VK_APPS},
+        {"VOLUME_MUTE", VK_VOLUME_MUTE}, {"VOLUME_DOWN", VK_VOLUME_DOWN},
+        {"VOLUME_UP", VK_VOLUME_UP}, {"MEDIA_NEXT", VK_MEDIA_NEXT_TRACK},
+        {"MEDIA_PREV", VK_MEDIA_PREV_TRACK}, {"MEDIA_PLAY", VK_MEDIA_PLAY_PAUSE}
+    };
+
+    std::string upper;
+    upper.reserve(keyName.size());
+    for (char c : keyName) {
+        upper.push_back(static_cast<char>(std::toupper(static_cast<unsigned char>(c))));
+    }
+
+    // strip "VK_" prefix if present
+    if (upper.rfind("VK_", 0) == 0) {
+        upper.erase(0, 3);
+    }
+    else if (upper.rfind("VK", 0) == 0) {
+        upper.erase(0, 2);
+    }
+
+    auto it = keyMap.find(upper);
+    if (it != keyMap.end()) {
+        return it->second;
+    }
+
+    // If single alphanumeric char, try VkKeyScanA
+    if (upper.size() == 1) {
+        char c = upper[0];
+        if (std::isalnum(static_cast<unsigned char>(c))) {
+            SHORT vk = VkKeyScanA(c);
+            if (vk != -1)
+                return LOBYTE(vk);
+        }
+    }
+
+    // If that fails, try numeric parse
+    try {
+        int vkCode = std::stoi(upper);
+        if (vkCode >= 0 && vkCode <= 255) {
+            return vkCode;
+        }
+    }
+    catch (...) {
+        // ignore
+    }
+    throw std::runtime_error(
+        "Cannot map key '" + std::string(keyName) + "' to a VK code"
+    );
+}
+
+WORD VirtualPianoPlayer::vkToScanCode(int vk) {
+    return static_cast<WORD>(MapVirtualKey(vk, MAPVK_VK_TO_VSC));
+}
+
+void VirtualPianoPlayer::sendVirtualKey(WORD vk, bool press) {
+    INPUT in = virtualKeyInput(vk, press);
+    sendInputs(&in, 1);
+}
+
+void VirtualPianoPlayer::pressKey(WORD vk) {
+    sendVirtualKey(vk, true);
+}
+
+void VirtualPianoPlayer::releaseKey(WORD vk) {
+    sendVirtualKey(vk, false);
+}
+
+void VirtualPianoPlayer::press_key(int note) noexcept {
+    if (note < 0 || note > 127)
+        return;
+    const int actual = ENABLE_OUT_OF_RANGE_TRANSPOSE ? transpose_note(note) : note;
+    if (actual < 0 || actual > 127)
+        return;
+    const KeySequence* seq = (eightyEightKeyModeActive ? g_fullNoteKeys : g_limitedNoteKeys)[actual];
+    if (seq) {
+        lift_held_key(note, seq);
+        held_keys[note].store(static_cast<uint8_t>(actual), std::memory_order_relaxed);
+        held_sequences[note].store(seq, std::memory_order_relaxed);
+        // if it wasn't already pressed, press it
+        if (!pressed_notes[actual].exchange(true, std::memory_order_relaxed)) {
+            sendKeySequence(*seq, true);
+        }
+        else {
+            // If it was already pressed, do a quick release/re-press
+            sendKeySequence(*seq, false);
+            sendKeySequence(*seq, true);
+        }
+    }
+}
+
+void VirtualPianoPlayer::lift_held_key(int note, const KeySequence* keep) noexcept {
+    const KeySequence* held = held_sequences[note].exchange(nullptr, std::memory_order_relaxed);
+    if (held && held != keep &&
+        pressed_notes[held_keys[note].load(std::memory_order_relaxed)].exchange(false, std::memory_order_relaxed))
+        sendKeySequence(*held, false);
+}
+
+void VirtualPianoPlayer::release_key(int note) noexcept {
+    if (note < 0 || note > 127)
+        return;
+    // The key press_key chose, not what the current transpose and layout would choose.
+    const KeySequence* seq = held_sequences[note].exchange(nullptr, std::memory_order_relaxed);
+    if (!seq)
+        return;
+    const uint8_t actual = held_keys[note].load(std::memory_order_relaxed);
+    if (pressed_notes[actual].exchange(false, std::memory_order_relaxed))
+        sendKeySequence(*seq, false);
+}
+
+int VirtualPianoPlayer::transpose_note(int midi_n) noexcept {
+    int transposed = (midi_n < 36) ? 36 + (midi_n % 12)
+                     : (midi_n > 96) ? 96 - (11 - (midi_n % 12))
+                     : midi_n;
+    if (transposed > midi_n + 24) {
+        transposed = midi_n + 24;
+    }
+    else if (transposed < midi_n - 24) {
+        transposed = midi_n - 24;
+    }
+    return transposed;
+}
+
+std::string VirtualPianoPlayer::get_note_name(int midi_note) {
+    static constexpr const char* NAMES[12] = {
+        "C","C#","D","D#","E","F","F#","G","G#","A","A#","B"
+    };
+    int octave = (midi_note / 12) - 1;
+    int pitch  = midi_note % 12;
+    if (pitch < 0 || pitch > 11)
+        return "Unknown";
+    return std::string(NAMES[pitch]) + std::to_string(octave);
+}
+
+std::string VirtualPianoPlayer::getVelocityCurveName(midi::VelocityCurveType curveType) {
+    using VT = midi::VelocityCurveType;
+    switch (curveType) {
+    case VT::LinearCoarse:       return "Linear Coarse";
+    case VT::LinearFine:         return "Linear Fine";
+    case VT::ImprovedLowVolume:  return "Improved Low Volume";
+    case VT::Logarithmic:        return "Logarithmic";
+    case VT::Exponential:        return "Exponential";
+    default:                     return "Unknown";
+    }
+}
+
+void VirtualPianoPlayer::setVelocityCurveIndex(size_t index) {
+    auto& cfg = midi::Config::getInstance();
+    size_t mx = 5 + cfg.playback.customVelocityCurves.size();
+    currentVelocityCurveIndex = std::min(index, mx);
+}
+
+std::string VirtualPianoPlayer::getVelocityKey(int targetVelocity) {
+    static constexpr std::array<int, 32> builtinCurves[5] = {
+        {4,8,12,16,20,24,28,32,36,40,44,48,52,56,60,64,68,72,76,80,84,88,92,96,100,104,108,112,116,120,124,127},
+        {2,6,10,14,18,22,26,30,34,38,42,46,50,54,58,62,66,70,74,78,82,86,90,94,98,102,106,110,114,118,122,127},
+        {1,3,5,7,10,13,16,20,24,29,34,40,46,53,60,68,76,85,94,104,114,120,123,127,127,127,127,127,127,127,127,127},
+        {1,2,3,5,7,10,14,19,25,32,40,49,60,72,85,99,115,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127},
+        {1,2,4,8,16,24,32,40,48,56,64,72,80,88,96,104,110,115,120,124,126,127,127,127,127,127,127,127,127,127,127,127}
+    };
+    static constexpr char velocityKeys[] = "1234567890qwertyuiopasdfghjklzxc";
+    const auto& config = midi::Config::getInstance();
+    const auto& velocityTable = (currentVelocityCurveIndex < 5)
+        ? builtinCurves[currentVelocityCurveIndex]
+        : config.playback.customVelocityCurves[currentVelocityCurveIndex - 5].velocityValues;
+
+    int idx = 0;
+    while (idx < 32 && velocityTable[idx] < targetVelocity) {
+        ++idx;
+    }
+    return std::string(1, velocityKeys[(idx < 32) ? idx : 31]);
+}
+
+void VirtualPianoPlayer::toggle_88_key_mode() {
+    eightyEightKeyModeActive = !eightyEightKeyModeActive;
+    std::cout << "[88-KEY MODE] "
+              << (eightyEightKeyModeActive ? "Enabled" : "Disabled")
+              << "\n";
+}
+
+void VirtualPianoPlayer::toggle_volume_adjustment() {
+    bool newVal = !enable_volume_adjustment.load(std::memory_order_relaxed);
+    enable_volume_adjustment.store(newVal, std::memory_order_relaxed);
+    if (newVal) {
+        max_volume = midi::Config::getInstance().volume.MAX_VOLUME;
+        precompute_volume_adjustments();
+        calibrate_volume();
+        std::cout << "[AUTOVOL] On. Initial="
+                  << midi::Config::getInstance().volume.INITIAL_VOLUME
+                  << "% Step="
+                  << midi::Config::getInstance().volume.VOLUME_STEP
+                  << "% Max="
+                  << midi::Config::getInstance().volume.MAX_VOLUME << "%\n";
+    }
+    else {
+        std::cout << "[AUTOVOL] Off.\n";
+    }
+}
+
+void VirtualPianoPlayer::toggle_velocity_keypress() {
+    bool newVal = !enable_velocity_keypress.load(std::memory_order_relaxed);
+    enable_velocity_keypress.store(newVal, std::memory_order_relaxed);
+    std::cout << "[VELOCITY KEY] "
+              << (newVal ? "Enabled" : "Disabled") << "\n";
+    if (newVal) {
+        std::cout << "[WARNING] ALT+key combos in use; ensure no conflicting overlays.\n";
+    }
+}
+
+void VirtualPianoPlayer::precompute_volume_adjustments() {
+    int currMaxVol = max_volume.load(std::memory_order_relaxed);
+    for (int v = 0; v < 128; ++v) {
+        double ratio = static_cast<double>(v) / 127.0;
+        int tv       = static_cast<int>(ratio * currMaxVol);
+        int mn       = std::min(midi::Config::getInstance().volume.MIN_VOLUME,
+                                currMaxVol);
+        int mx       = std::max(midi::Config::getInstance().volume.MIN_VOLUME,
+                                currMaxVol);
+        tv = std::clamp(tv, mn, mx);
+        // Round to nearest 10
+        tv = ((tv + 5) / 10) * 10;
+        volume_lookup[v] = tv;
+    }
+}
+
+void VirtualPianoPlayer::calibrate_volume() {
+    auto& vc = midi::Config::getInstance().volume;
+
+    // Force volume down many times
+    for (int i = 0; i < 50; ++i) {
+        arrowsend(volume_down_key_code, true);
+        for (volatile int j = 0; j < 8000; ++j) {} // small busy loop
+    }
+    double cf = (vc.INITIAL_VOLUME > 150) ? 1.1 : 1.0;
+    int steps = static_cast<int>(
+                    std::ceil(((vc.INITIAL_VOLUME - vc.MIN_VOLUME) /
+                                vc.VOLUME_STEP) * cf));
+
+    for (int i = 0; i < steps; ++i) {
+        arrowsend(volume_up_key_code, true);
+        for (volatile int j = 0; j < (8000 + (i > 10 ? (i - 10) * 300 : 0)); ++j) {}
+    }
+
+    current_volume.store(vc.INITIAL_VOLUME, std::memory_order_relaxed);
+}
+
+void VirtualPianoPlayer::AdjustVolumeBasedOnVelocity(int velocity) noexcept {
+    if (velocity < 0 || velocity >= static_cast<int>(volume_lookup.size()))
+        return;
+
+    int target_vol = volume_lookup[velocity];
+    int current_vol= current_volume.load(std::memory_order_relaxed);
+    int diff       = target_vol - current_vol;
+    int step_size  = midi::Config::getInstance().volume.VOLUME_STEP;
+    if (std::abs(diff) >= step_size) {
+        WORD sc = (diff > 0) ? volume_up_key_code : volume_down_key_code;
+        int steps = std::abs(diff) / step_size;
+        for (int i = 0; i < steps; ++i) {
+            arrowsend(sc, true);
+        }
+        current_volume.store(target_vol, std::memory_order_relaxed);
+    }
+}
+
+void VirtualPianoPlayer::toggle_out_of_range_transpose() {
+    ENABLE_OUT_OF_RANGE_TRANSPOSE = !ENABLE_OUT_OF_RANGE_TRANSPOSE;
+    std::cout << "[TRANSPOSE] "
+              << (ENABLE_OUT_OF_RANGE_TRANSPOSE ? "Enabled" : "Disabled")
+              << "\n";
+}
+
+int VirtualPianoPlayer::toggle_transpose_adjustment() {
+    auto [notes, durations] = transposeEngine.extractNotesAndDurations(midi_file);
+    if (notes.empty()) {
+        std::cout << "[TRANSPOSE] No notes.\n";
+        return 0;
+    }
+    std::string key   = transposeEngine.estimateKey(notes, durations);
+    std::string genre = transposeEngine.detectGenre(midi_file, notes, durations);
+    std::cout << "Detected key: " << key << "\nDetected genre: " << genre << "\n";
+    return transposeEngine.findBestTranspose(notes, durations, key, genre);
+}
+
+namespace {
+    bool isScheduledEvent(uint8_t status, uint8_t data1) noexcept {
+        uint8_t kind = status & 0xF0;
+        return kind == 0x90 || kind == 0x80 || (kind == 0xB0 && data1 == 64);
+    }
+
+    // k-way merge of the tracks' note/CC64 events as a loser tree: O(log k) per
+    // event instead of scanning every track head. Ties go to the lower track index,
+    // and events are read from the columns in place, never copied.
+    class TrackMerge {
+    public:
+        struct Head {
+            uint32_t tick;
+            uint8_t status;
+            uint8_t data1;
+            uint8_t data2;
+            int track;
+        };
+
+        explicit TrackMerge(const MidiFile& mid) {
+            for (int t = 0; t < static_cast<int>(mid.tracks.size()); ++t) {
+                const auto& events = mid.tracks[t].events;
+                if (!events.empty())
+                    sources.push_back({ &events, 0, t });
+            }
+            const size_t k = sources.size();
+            keys.resize(k);
+            for (size_t i = 0; i < k; ++i) {
+                skipToScheduled(sources[i]);
+                keys[i] = keyOf(sources[i]);
+            }
+            if (k == 0)
+                return;
+            // Leaves sit at k..2k-1 of an implicit heap; play every match bottom-up once.
+            losers.resize(k);
+            std::vector<size_t> winners(2 * k);
+            for (size_t i = 0; i < k; ++i)
+                winners[k + i] = i;
+            for (size_t node = k - 1; node >= 1; --node) {
+                size_t a = winners[2 * node], b = winners[2 * node + 1];
+                if (keys[b] < keys[a])
+                    std::swap(a, b);
+                winners[node] = a;
+                losers[node] = b;
+            }
+            losers[0] = winners[1];
+        }
+
+        [[nodiscard]] bool done() const noexcept { return losers.empty() || keys[losers[0]] == EXHAUSTED; }
+
+        [[nodiscard]] Head head() const noexcept {
+            const Source& s = sources[losers[0]];
+            return { s.events->tick(s.pos), s.events->status(s.pos),
+                     s.events->data1(s.pos), s.events->data2(s.pos), s.track };
+        }
+
+        void pop() noexcept {
+            size_t winner = losers[0];
+            Source& s = sources[winner];
+            ++s.pos;
+            skipToScheduled(s);
+            keys[winner] = keyOf(s);
+            const size_t k = sources.size();
+            for (size_t node = (winner + k) / 2; node >= 1; node /= 2) {
+                if (keys[losers[node]] < keys[winner])
+                    std::swap(losers[node], winner);
+            }
+            losers[0] = winner;
+        }
+
+    private:
+        struct Source {
+            const MidiEventStore* events;
+            size_t pos;
+            int track;
+        };
+        static constexpr uint64_t EXHAUSTED = ~0ULL;
+
+        static void skipToScheduled(Source& s) noexcept {
+            const size_t n = s.events->size();
+            while (s.pos < n && !isScheduledEvent(s.events->status(s.pos), s.events->data1(s.pos)))
+                ++s.pos;
+        }
+        // Tick in the high half, track in the low half: one compare orders both.
+        static uint64_t keyOf(const Source& s) noexcept {
+            if (s.pos >= s.events->size())
+                return EXHAUSTED;
+            return (static_cast<uint64_t>(s.events->tick(s.pos)) << 32) | static_cast<uint32_t>(s.track);
+        }
+
+        std::vector<Source> sources;
+        std::vector<uint64_t> keys;
+        std::vector<size_t> losers;   // [0] = overall winner, [n] = loser of match n
+    };
+}
+
+void VirtualPianoPlayer::stop_schedule() {
+    if (schedule_thread) {
+        schedule_thread->request_stop();
+        if (schedule_thread->joinable())
+            schedule_thread->join();
+        schedule_thread.reset();
+    }
+}
+
+void VirtualPianoPlayer::process_tracks(const MidiFile& mid, std::filesystem::path cache_file) {
+    // The producer reads `mid` and writes note_buffer; neither may change under it.
+    stop_schedule();
+    reset_program();
+    schedule_cache_file = std::move(cache_file);
+    tempo_changes.clear();
+    timeSignatures.clear();
+
+    track_features = analyzeTracks(mid);
+    track_features_partial = false;
+    schedule_settings = current_schedule_settings();
+    detect_drums();
+
+    // Tempo and time signature lists come straight from the parser, in tick order.
+    std::vector<TempoChange> tempos(mid.tempoChanges);
+    std::stable_sort(tempos.begin(), tempos.end(),
+                     [](const TempoChange& a, const TempoChange& b) { return a.tick < b.tick; });
+    for (const auto& tc : tempos) {
+        tempo_changes.push_back({ static_cast<double>(tc.tick),
+                                  static_cast<double>(tc.microsecondsPerQuarter) });
+    }
+    timeSignatures = mid.timeSignatures;
+    std::stable_sort(timeSignatures.begin(), timeSignatures.end(),
+                     [](const TimeSignature& a, const TimeSignature& b) { return a.tick < b.tick; });
+
+    // Upper bound on schedule entries: one per note/CC64 event, plus a closing
+    // release per note-on. note_buffer is sized to it once, before the producer starts.
+    size_t bound = 0;
+    size_t scheduledMessages = 0;
+    uint32_t lastTick = 0;
+    for (const auto& track : mid.tracks) {
+        const auto& events = track.events;
+        for (size_t i = 0; i < events.size(); ++i) {
+            uint8_t status = events.status(i);
+            if (!isScheduledEvent(status, events.data1(i)))
+                continue;
+            ++scheduledMessages;
+            bound += ((status & 0xF0) == 0x90 && events.data2(i) > 0) ? 2 : 1;
+            lastTick = std::max(lastTick, events.tick(i));
+        }
+    }
+    tempo_map = TempoMap(mid);
+    schedule_end = tempo_map.toTime(lastTick);
+
+    {
+        std::lock_guard<std::mutex> lock(buffer_mutex);
+        reset_note_buffer(bound);
+        event_pool.reset();
+    }
+    merged_events.clear();
+    merged_events.reserve(scheduledMessages);
+    merged_complete = false;
+    scheduled_count.store(0, std::memory_order_release);
+    schedule_horizon_ns.store(std::numeric_limits<int64_t>::min(), std::memory_order_release);
+    schedule_done.store(false, std::memory_order_release);
+
+    schedule_thread = std::make_unique<std::jthread>([this, &mid](std::stop_token stop) {
+        produce_schedule(mid, stop);
+    });
+    if (!midi::Config::getInstance().midi.STREAMING_LOAD)
+        wait_for_schedule(std::chrono::nanoseconds::max());
+}
+
+void VirtualPianoPlayer::produce_schedule(const MidiFile& mid, std::stop_token stop) {
+    TempoMap::Cursor clock(tempo_map);
+    std::chrono::nanoseconds current_time_ns(0);
+
+    // Open notes, pedal state and duplicate groups
+    ScheduleBuild build = start_schedule_build();
+    // Thinning and the polyphony limit need the whole schedule, so nothing is published before they ran.
+    const bool postPasses = has_schedule_passes();
+    hold_scheduled_count = postPasses;
+
+    TrackMerge merge(mid);
+    size_t merged = 0;
+    for (; !merge.done(); merge.pop()) {
+        if ((++merged & 0x3FF) == 0) {
+            if (stop.stop_requested()) {
+                // Leave a truncated but consistent schedule behind; held back (empty) if passes were due.
+                schedule_done.store(true, std::memory_order_release);
+                schedule_cv.notify_all();
+                return;
+            }
+            schedule_cv.notify_all();
+        }
+        const TrackMerge::Head evt = merge.head();
+        current_time_ns = clock.toTime(evt.tick);
+
+        // Kept so a settings change can redo pairing without merging again.
+        merged_events.push_back({ current_time_ns, static_cast<uint16_t>(evt.track),
+                                  evt.status, evt.data1, evt.data2 });
+        schedule_merged_event(merged_events.back(), build);
+        if (!postPasses)
+            schedule_horizon_ns.store(current_time_ns.count(), std::memory_order_release);
+    }
+    close_active_notes(current_time_ns, build.active_notes);
+    merged_complete = true;
+    report_schedule_build(build);
+    finish_schedule_passes();
+
+    schedule_horizon_ns.store(std::numeric_limits<int64_t>::max(), std::memory_order_release);
+    schedule_done.store(true, std::memory_order_release);
+    schedule_cv.notify_all();
+
+    refresh_program();
+
+    // Only a complete schedule is worth keeping; a stopped one returned above.
+    if (!schedule_cache_file.empty())
+        save_schedule_cache();
+
+    // A settings change made while we streamed. If reprocess_schedule holds the lock it
+    // will see the finished schedule and join us, so don't wait for it.
+    if (reprocess_pending.load(std::memory_order_acquire) && !stop.stop_requested()) {
+        std::unique_lock<std::mutex> serialize(reprocess_mutex, std::try_to_lock);
+        if (serialize && reprocess_pending.exchange(false, std::memory_order_acq_rel))
+            reprocess_locked();
+    }
+}
+
+void VirtualPianoPlayer::schedule_merged_event(const MergedEvent& evt, ScheduleBuild& build) {
+    const int trackIdx = evt.track;
+    if ((evt.status & 0xF0) == 0xB0) {
+        // sustain pedal; the merge only passes CC64
+        add_sustain_event(evt.time,
+                          evt.status & 0x0F,
+                          evt.data2,
+                          trackIdx,
+                          build.pedals);
+        return;
+    }
+    int note     = evt.data1;
+    int channel  = evt.status & 0x0F;
+    int velocity = evt.data2;
+
+    if ((evt.status & 0xF0) == 0x90 && velocity > 0) {
+        handle_note_on(evt.time,
+                       channel,
+                       note,
+                       velocity,
+                       trackIdx,
+                       build);
+    }
+    else {
+        handle_note_off(evt.time,
+                        channel,
+                        note,
+                        velocity,
+                        trackIdx,
+                        build);
+    }
+}
+
+void VirtualPianoPlayer::close_active_notes(std::chrono::nanoseconds ctime, ActiveNoteTracker& active_notes) {
+    // Nothing is tracked under NoHandling; FIFO and LIFO release every open start.
+    active_notes.drain([&](int, int note, std::chrono::nanoseconds) {
+        add_note_event(ctime, note, EventType::Release, 0, -1);
+    });
+}
+
+VirtualPianoPlayer::ScheduleBuild VirtualPianoPlayer::start_schedule_build() {
+    const auto& settings = midi::Config::getInstance().midi;
+    const auto dedupWindow = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::duration<double, std::milli>(settings.DEDUP_WINDOW_MS));
+    return ScheduleBuild{ midi::Config::getInstance().playback.noteHandlingMode,
+                          ActiveNoteTracker{},
+                          SustainCoalescer(settings.SUSTAIN_COALESCE, g_sustainCutoff, settings.SUSTAIN_HYSTERESIS),
+                          DuplicateNoteFilter(settings.DEDUP_NOTES, dedupWindow) };
+}
+
+void VirtualPianoPlayer::report_schedule_build(const ScheduleBuild& build) {
+    const SustainCoalescer& pedals = build.pedals;
+    if (pedals.droppedCount() > 0) {
+        std::cout << "[Sustain] Coalesced " << pedals.seenCount() << " pedal events to "
+                  << pedals.seenCount() - pedals.droppedCount() << " cutoff crossings ("
+                  << pedals.droppedCount() << " dropped)\n";
+    }
+    const DuplicateNoteFilter& duplicates = build.duplicates;
+    if (duplicates.duplicateCount() > 0) {
+        std::cout << "[Dedup] " << duplicates.duplicateCount()
+                  << " duplicate presses skipped while their leading track plays\n";
+        // Largest overlaps first; a handful is enough to spot doubled parts.
+        std::vector<std::pair<uint32_t, std::pair<int, int>>> pairs;
+        for (const auto& [tracks, count] : duplicates.pairs())
+            pairs.push_back({ count, tracks });
+        const size_t shown = std::min<size_t>(pairs.size(), 5);
+        std::partial_sort(pairs.begin(), pairs.begin() + shown, pairs.end(),
+                          [](const auto& a, const auto& b) { return a.first > b.first; });
+        for (size_t i = 0; i < shown; ++i) {
+            std::cout << "[Dedup]   Track #" << pairs[i].second.first << " doubles track #"
+                      << pairs[i].second.second << ": " << pairs[i].first << " presses\n";
+        }
+    }
+}
+
+VirtualPianoPlayer::ScheduleSettings VirtualPianoPlayer::current_schedule_settings() {
+    const auto& config = midi::Config::getInstance();
+    return { config.playback.noteHandlingMode, config.midi.DETECT_DRUMS, config.midi.DRUM_THRESHOLD, g_sustainCutoff };
+}
+
+void VirtualPianoPlayer::detect_drums() {
+    drum_flags.clear();
+    const auto& midiSettings = midi::Config::getInstance().midi;
+    if (!midiSettings.DETECT_DRUMS)
+        return;
+    // One threshold for every track. It was meant to be 0.9 for unnamed tracks,
+    // but those were checked as "(no name)", so in practice every track got 0.8.
+    const double threshold = midiSettings.DRUM_THRESHOLD;
+    drum_flags.resize(track_features.size(), false);
+    for (size_t i = 0; i < track_features.size(); ++i) {
+        const TrackFeatures& features = track_features[i];
+        double conf = features.drumConfidence();
+        double clampedConf = (conf > 1.0 ? 1.0 : conf);
+        if (clampedConf >= threshold) {
+            drum_flags[i] = true;
+            const std::string trackName = features.name.empty() ? std::string("(no name)") : TrackFeatures::text(features.name);
+            std::cout << "[DRUMS] Track #" << i
+                      << " \"" << trackName
+                      << "\" flagged as drums (confidence: "
+                      << std::fixed << std::setprecision(1)
+                      << clampedConf * 100 << "%, raw: "
+                      << conf << ")\n";
+        }
+    }
+}
+
+void VirtualPianoPlayer::merge_events(const MidiFile& mid) {
+    // Same stream produce_schedule keeps, for schedules that came from the cache.
+    merged_events.clear();
+    TempoMap::Cursor clock(tempo_map);
+    for (TrackMerge merge(mid); !merge.done(); merge.pop()) {
+        const TrackMerge::Head evt = merge.head();
+        merged_events.push_back({ clock.toTime(evt.tick), static_cast<uint16_t>(evt.track),
+                                  evt.status, evt.data1, evt.data2 });
+    }
+    merged_complete = true;
+}
+
+void VirtualPianoPlayer::rebuild_schedule() {
+    size_t bound = 0;
+    for (const auto& evt : merged_events)
+        bound += ((evt.status & 0xF0) == 0x90 && evt.data2 > 0) ? 2 : 1;
+
+    // Readers wait on schedule_done, as they do while the producer streams.
+    reset_program();
+    schedule_done.store(false, std::memory_order_release);
+    schedule_horizon_ns.store(std::numeric_limits<int64_t>::min(), std::memory_order_release);
+    scheduled_count.store(0, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lock(buffer_mutex);
+        reset_note_buffer(bound);
+        event_pool.reset();
+    }
+    ScheduleBuild build = start_schedule_build();
+    hold_scheduled_count = has_schedule_passes();
+    for (const auto& evt : merged_events)
+        schedule_merged_event(evt, build);
+    close_active_notes(merged_events.empty() ? std::chrono::nanoseconds(0) : merged_events.back().time,
+                       build.active_notes);
+    report_schedule_build(build);
+    finish_schedule_passes();
+
+    schedule_horizon_ns.store(std::numeric_limits<int64_t>::max(), std::memory_order_release);
+    schedule_done.store(true, std::memory_order_release);
+    schedule_cv.notify_all();
+}
+
+void VirtualPianoPlayer::rethreshold_sustain() {
+    // The cutoff only decides each pedal event's action; the events themselves stay.
+    reset_program();
+    const size_t count = scheduled_events();
+    for (size_t i = 0; i < count; ++i) {
+        NoteEvent& e = *note_buffer[i];
+        if (e.isSustain)
+            e.action = (e.sustainValue >= g_sustainCutoff) ? EventType::Press : EventType::Release;
+    }
+}
+
+bool VirtualPianoPlayer::has_schedule_passes() {
+    const auto& settings = midi::Config::getInstance().midi;
+    return settings.THIN_NOTES || settings.POLYPHONY_LIMIT > 0;
+}
+
+void VirtualPianoPlayer::finish_schedule_passes() {
+    // Passes over the complete schedule, before it is published: with any of them
+    // on, append_schedule_event left scheduled_count at 0 so nobody reads entries
+    // these passes drop, move or reallocate.
+    const auto& settings = midi::Config::getInstance().midi;
+    thinning_stats = {};
+    if (settings.THIN_NOTES)
+        thin_schedule();
+    if (settings.POLYPHONY_LIMIT > 0)
+        limit_polyphony();
+    hold_scheduled_count = false;
+    scheduled_count.store(note_count, std::memory_order_release);
+}
+
+void VirtualPianoPlayer::thin_schedule() {
+    const auto& settings = midi::Config::getInstance().midi;
+    thinning::Options options;
+    options.window = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::duration<double, std::milli>(settings.THIN_WINDOW_MS));
+    options.maxKeysPerWindow = static_cast<uint32_t>(settings.THIN_MAX_KEYS_PER_WINDOW);
+    options.shortNote = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::duration<double, std::milli>(settings.THIN_SHORT_NOTE_MS));
+
+    // A press lasts until the next release of its key, which is when the key really comes up.
+    std::vector<thinning::Note> presses;
+    std::array<std::vector<uint32_t>, 128> held;
+    for (size_t i = 0; i < note_count; ++i) {
+        const NoteEvent* e = note_buffer[i];
+        if (e->isSustain)
+            continue;
+        if (e->action == EventType::Press) {
+            held[e->note].push_back(static_cast<uint32_t>(presses.size()));
+            const bool drum = e->trackIndex >= 0 && static_cast<size_t>(e->trackIndex) < drum_flags.size() &&
+                              drum_flags[e->trackIndex];
+            presses.push_back({ e->time, std::chrono::nanoseconds::max(), e->note,
+                                static_cast<uint8_t>(e->velocity), e->coveredBy >= 0, drum });
+        }
+        else {
+            for (uint32_t index : held[e->note])
+                presses[index].duration = e->time - presses[index].time;
+            held[e->note].clear();
+        }
+    }
+
+    std::vector<bool> keep;
+    thinning_stats = thinning::thin(presses, options, keep);
+    if (thinning_stats.droppedNotes == 0)
+        return;
+
+    // Only presses go; their releases stay, since a muted track can leave another copy of the key down.
+    size_t press = 0;
+    NoteEvent** first = note_buffer.get();
+    note_count = static_cast<size_t>(std::remove_if(first, first + note_count, [&](const NoteEvent* e) {
+        return !e->isSustain && e->action == EventType::Press && !keep[press++];
+    }) - first);
+
+    uint32_t busiest = 0;
+    for (const auto& window : thinning_stats.windows)
+        busiest = std::max(busiest, window.requested);
+    std::cout << "[Thin] Dropped " << thinning_stats.droppedNotes << " of " << thinning_stats.requestedNotes
+              << " notes in " << thinning_stats.windowsOverBudget << " of " << thinning_stats.windows.size()
+              << " windows (budget " << options.maxKeysPerWindow << " keys per "
+              << std::fixed << std::setprecision(0) << settings.THIN_WINDOW_MS << " ms, busiest asked for "
+              << busiest << ")\n";
+}
+
+void VirtualPianoPlayer::limit_polyphony() {
+    const auto& settings = midi::Config::getInstance().midi;
+    polyphony::Policy policy = polyphony::Policy::Oldest;
+    polyphony::policyFromName(settings.POLYPHONY_STEAL, policy);
+
+    std::vector<polyphony::Event> keys;
+    std::vector<size_t> positions;   // note_buffer index of each key event
+    keys.reserve(note_count);
+    positions.reserve(note_count);
+    for (size_t i = 0; i < note_count; ++i) {
+        const NoteEvent* e = note_buffer[i];
+        if (e->isSustain)
+            continue;
+        keys.push_back({ e->time, e->note, static_cast<uint8_t>(e->velocity), e->action == EventType::Press });
+        positions.push_back(i);
+    }
+    const polyphony::Result result = polyphony::limit(keys, static_cast<uint32_t>(settings.POLYPHONY_LIMIT), policy);
+    if (result.releases.empty() && result.droppedPresses.empty())
+        return;
+
+    // Each early release goes right before the press that needed its key. Track -1
+    // keeps it from being muted: the limit assumes every track plays.
+    // Unpublished still, so the slots can be replaced by a larger set.
+    const size_t capacity = note_count + result.releases.size();
+    auto limited = std::make_unique_for_overwrite<NoteEvent*[]>(capacity);
+    size_t size = 0;
+    size_t next = 0;
+    size_t nextDrop = 0;
+    for (size_t i = 0; i < note_count; ++i) {
+        for (; next < result.releases.size() && positions[result.releases[next].before] == i; ++next) {
+            limited[size++] = event_pool.allocate(note_buffer[i]->time, result.releases[next].note,
+                                                  EventType::Release, 0, false, 0, -1);
+        }
+        if (nextDrop < result.droppedPresses.size() && positions[result.droppedPresses[nextDrop]] == i) {
+            ++nextDrop;
+            continue;
+        }
+        limited[size++] = note_buffer[i];
+    }
+    note_buffer = std::move(limited);
+    note_capacity = capacity;
+    note_count = size;
+
+    std::cout << "[Poly] Inserted " << result.releases.size() << " early releases to hold at most "
+              << settings.POLYPHONY_LIMIT << " keys (" << settings.POLYPHONY_STEAL
+              << "; the song asks for up to " << result.peakRequested << ")\n";
+    if (!result.droppedPresses.empty())
+        std::cout << "[Poly] Dropped " << result.droppedPresses.size() << " presses of chords wider than the limit\n";
+}
+
+PlaybackProgram::Options VirtualPianoPlayer::current_program_options() const {
+    PlaybackProgram::Options options;
+    options.fullKeys = eightyEightKeyModeActive.load(std::memory_order_relaxed);
+    options.outOfRangeTranspose = ENABLE_OUT_OF_RANGE_TRANSPOSE;
+    options.velocityKeys = enable_velocity_keypress.load(std::memory_order_relaxed);
+    options.velocityCurve = options.velocityKeys ? currentVelocityCurveIndex : 0;
+    options.sustainMode = static_cast<int>(currentSustainMode);
+    options.sustainCutoff = g_sustainCutoff;
+    return options;
+}
+
+void VirtualPianoPlayer::reset_program() {
+    program.store(nullptr, std::memory_order_release);
+    program_version.fetch_add(1, std::memory_order_release);
+}
+
+void VirtualPianoPlayer::refresh_program() {
+    if (!midi::Config::getInstance().autoplayer_timing.COMPILED_PLAYBACK || !schedule_complete() ||
+        scheduled_events() == 0)
+        return;
+    const auto current = program.load(std::memory_order_acquire);
+    if (current && current->options == current_program_options())
+        return;
+    compile_program();
+}
+
+void VirtualPianoPlayer::compile_program() {
+    // Beyond this (about 80 MB of INPUT) the program costs more memory than the walk saves time.
+    constexpr size_t MAX_INPUTS = size_t(1) << 21;
+    const auto started = std::chrono::steady_clock::now();
+    auto compiled = std::make_shared<PlaybackProgram>();
+    PlaybackProgram& prog = *compiled;
+    prog.options = current_program_options();
+    const auto& noteKeys = prog.options.fullKeys ? g_fullNoteKeys : g_limitedNoteKeys;
+    const auto sustainMode = static_cast<SustainMode>(prog.options.sustainMode);
+    const size_t count = scheduled_events();
+
+    // Replay state, as execute_note_event would leave it.
+    std::array<bool, 128> held{};
+    bool sustain = false;
+    int16_t velocityKey = -1;
+
+    auto pedal = [&](bool down) {
+        prog.inputs.push_back(virtualKeyInput(sustain_key_code, down));
+        sustain = down;
+    };
+    auto velocityKeyIndex = [&](const std::string& name) -> int16_t {
+        for (size_t k = 0; k < prog.velocityKeys.size(); ++k) {
+            if (prog.velocityKeys[k] == name)
+                return static_cast<int16_t>(k);
+        }
+        const KeySequence seq = computeKeySequence(name);
+        std::vector<INPUT> tap(seq.events_press);
+        tap.insert(tap.end(), seq.events_release.begin(), seq.events_release.end());
+        prog.velocityKeys.push_back(name);
+        prog.velocityTaps.push_back(std::move(tap));
+        return static_cast<int16_t>(prog.velocityKeys.size() - 1);
+    };
+
+    try {
+        prog.inputs.reserve(std::min(count * 2, MAX_INPUTS));
+        for (size_t first = 0; first < count;) {
+            const auto time = note_buffer[first]->time;
+            size_t last = first;
+            while (last < count && note_buffer[last]->time == time)
+                ++last;
+
+            PlaybackProgram::Step step{ time, 0, static_cast<uint32_t>(first), static_cast<uint32_t>(last - first),
+                                        static_cast<uint32_t>(prog.inputs.size()), 0,
+                                        static_cast<uint32_t>(prog.keyOps.size()), 0, velocityKey, sustain };
+            // We release notes first, then press new ones
+            for (const EventType pass : { EventType::Release, EventType::Press }) {
+                for (size_t i = first; i < last; ++i) {
+                    const NoteEvent& e = *note_buffer[i];
+                    if (e.action != pass)
+                        continue;
+                    if (e.trackIndex >= 0)
+                        step.trackMask |= uint64_t(1) << (e.trackIndex & 63);
+                    // Skipped while the doubled track plays, which the mask makes a condition of the step.
+                    if (e.coveredBy >= 0) {
+                        step.trackMask |= uint64_t(1) << (e.coveredBy & 63);
+                        continue;
+                    }
+
+                    if (e.isSustain) {
+                        const bool up = e.sustainValue < prog.options.sustainCutoff;
+                        if (sustainMode == SustainMode::SPACE_DOWN) {
+                            if (e.action == EventType::Press && !sustain && !up)
+                                pedal(true);
+                            else if (e.action == EventType::Release && sustain && up)
+                                pedal(false);
+                        }
+                        else if (sustainMode == SustainMode::SPACE_UP) {
+                            if (e.action == EventType::Release && !sustain && up)
+                                pedal(true);
+                            else if (e.action == EventType::Press && sustain && !up)
+                                pedal(false);
+                        }
+                        continue;
+                    }
+
+                    const int actual = prog.options.outOfRangeTranspose ? transpose_note(e.note) : e.note;
+                    if (actual < 0 || actual > 127)
+                        continue;
+                    const KeySequence* seq = noteKeys[actual];
+                    if (e.action == EventType::Press) {
+                        if (prog.options.velocityKeys && e.velocity != 0) {
+                            const int16_t key = velocityKeyIndex("alt+" + getVelocityKey(e.velocity));
+                            if (key != velocityKey) {
+                                const auto& tap = prog.velocityTaps[key];
+                                prog.inputs.insert(prog.inputs.end(), tap.begin(), tap.end());
+                                velocityKey = key;
+                            }
+                        }
+                        if (!seq)
+                            continue;
+                        // A held key is struck again.
+                        if (held[actual])
+                            appendKeySequence(prog.inputs, *seq, false);
+                        appendKeySequence(prog.inputs, *seq, true);
+                        held[actual] = true;
+                        prog.keyOps.push_back({ static_cast<uint8_t>(actual), e.note, true });
+                    }
+                    else if (seq) {
+                        // Released even if the replay thinks the key is up: muted tracks
+                        // and seeks can leave it down, and a stray key-up is harmless.
+                        appendKeySequence(prog.inputs, *seq, false);
+                        held[actual] = false;
+                        prog.keyOps.push_back({ static_cast<uint8_t>(actual), e.note, false });
+                    }
+                }
+            }
+            step.inputCount = static_cast<uint32_t>(prog.inputs.size() - step.firstInput);
+            step.keyOpCount = static_cast<uint32_t>(prog.keyOps.size() - step.firstKeyOp);
+            prog.steps.push_back(step);
+            if (prog.inputs.size() > MAX_INPUTS) {
+                std::cout << "[Program] Song too large to compile; playing it event by event.\n";
+                return;
+            }
+            first = last;
+        }
+    }
+    catch (const std::bad_alloc&) {
+        std::cerr << "[Program] Out of memory compiling; playing event by event.\n";
+        return;
+    }
+    prog.finalVelocityKey = velocityKey;
+    prog.finalSustain = sustain;
+
+    const auto ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+    std::cout << "[Program] Compiled " << count << " events into " << prog.steps.size() << " steps, "
+              << prog.inputs.size() << " inputs (" << std::fixed << std::setprecision(1)
+              << double(prog.inputs.size() * sizeof(INPUT)) / (1024.0 * 1024.0) << " MB) in " << ms << " ms\n";
+    program.store(std::move(compiled), std::memory_order_release);
+    program_version.fetch_add(1, std::memory_order_release);
+}
+
+bool VirtualPianoPlayer::reprocess_schedule() {
+    // The UI (sustain slider) and the hotkey thread (pause, note mode, drums) all get here.
+    std::lock_guard<std::mutex> serialize(reprocess_mutex);
+    return reprocess_locked();
+}
+
+bool VirtualPianoPlayer::reprocess_locked() {
+    if (!midiFileSelected.load(std::memory_order_acquire))
+        return false;
+    const ScheduleSettings wanted = current_schedule_settings();
+    const bool drumsChanged   = wanted.detectDrums != schedule_settings.detectDrums ||
+        (wanted.detectDrums && wanted.drumThreshold != schedule_settings.drumThreshold);
+    const bool pairingChanged = wanted.noteMode != schedule_settings.noteMode;
+    const bool sustainChanged = wanted.sustainCutoff != schedule_settings.sustainCutoff;
+    if (!drumsChanged && !pairingChanged && !sustainChanged)
+        return true;
+    if (!paused.load(std::memory_order_acquire)) {
+        std::cout << "[Reprocess] Settings changed; applying at the next pause.\n";
+        return false;
+    }
+    // A first build still streaming in is finished rather than cut short, but not waited
+    // for here: that could hold the UI for the whole file. The producer picks this up.
+    if (!schedule_complete()) {
+        reprocess_pending.store(true, std::memory_order_release);
+        std::cout << "[Reprocess] Settings changed; applying once the schedule has loaded.\n";
+        return false;
+    }
+    reprocess_pending.store(false, std::memory_order_release);
+    // note_buffer is torn down below; the playback thread must be off it first.
+    if (!wait_until_parked())
+        return false;
+    // The producer may still be saving the cache; when it is the caller, it is past that.
+    if (!schedule_thread || schedule_thread->get_id() != std::this_thread::get_id())
+        stop_schedule();
+
+    auto started = std::chrono::steady_clock::now();
+    if (drumsChanged) {
+        // A cache hit kept only the UI's part of the features; the drum score needs the rest.
+        // Copied over in place, as the UI may be reading the names and counts.
+        if (track_features_partial) {
+            const std::vector<TrackFeatures> full = analyzeTracks(midi_file);
+            std::copy(full.begin(), full.end(), track_features.begin());
+            track_features_partial = false;
+        }
+        detect_drums();
+    }
+    // Coalesced pedal events depend on the cutoff, so they are rebuilt rather than
+    // re-thresholded; thinning ranks drum tracks lower, so it reruns with new drum flags.
+    const auto& midiSettings = midi::Config::getInstance().midi;
+    if (pairingChanged || (sustainChanged && midiSettings.SUSTAIN_COALESCE) ||
+        (drumsChanged && midiSettings.THIN_NOTES)) {
+        if (!merged_complete)
+            merge_events(midi_file);
+        rebuild_schedule();
+    }
+    else if (sustainChanged) {
+        rethreshold_sustain();
+    }
+    schedule_settings = wanted;
+    refresh_program();
+
+    // Same playhead, new schedule: re-find our place in it.
+    buffer_index.store(find_next_event_index(total_adjusted_time), std::memory_order_release);
+    playback_control.requestResync();
+    signalPlayback();
+
+    auto ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+    std::cout << "[Reprocess] " << (pairingChanged ? "Re-paired notes" : sustainChanged ? "Re-applied sustain cutoff" : "Re-detected drums")
+              << " (" << scheduled_events() << " events) in "
+              << std::fixed << std::setprecision(1) << ms << " ms\n";
+    return true;
+}
+
+uint64_t VirtualPianoPlayer::schedule_settings_hash() {
+    // Everything that changes what process_tracks produces for the same file.
+    const auto& config = midi::Config::getInstance();
+    uint64_t hash = schedule_cache::FORMAT_VERSION;
+    hash = schedule_cache::combine(hash, static_cast<uint64_t>(config.playback.noteHandlingMode));
+    hash = schedule_cache::combine(hash, config.midi.DETECT_DRUMS ? 1 : 0);
+    if (config.midi.DETECT_DRUMS)
+        hash = schedule_cache::combine(hash, static_cast<uint64_t>(std::llround(config.midi.DRUM_THRESHOLD * 1000.0)));
+    hash = schedule_cache::combine(hash, static_cast<uint64_t>(static_cast<int64_t>(g_sustainCutoff)));
+    hash = schedule_cache::combine(hash, config.midi.SUSTAIN_COALESCE ? 1 : 0);
+    hash = schedule_cache::combine(hash, static_cast<uint64_t>(config.midi.SUSTAIN_HYSTERESIS));
+    hash = schedule_cache::combine(hash, config.midi.DEDUP_NOTES ? 1 : 0);
+    hash = schedule_cache::combine(hash, static_cast<uint64_t>(config.midi.POLYPHONY_LIMIT));
+    if (config.midi.POLYPHONY_LIMIT > 0) {
+        polyphony::Policy policy = polyphony::Policy::Oldest;
+        polyphony::policyFromName(config.midi.POLYPHONY_STEAL, policy);
+        hash = schedule_cache::combine(hash, static_cast<uint64_t>(policy));
+    }
+    hash = schedule_cache::combine(hash, config.midi.THIN_NOTES ? 1 : 0);
+    if (config.midi.THIN_NOTES) {
+        hash = schedule_cache::combine(hash, static_cast<uint64_t>(std::llround(config.midi.THIN_WINDOW_MS * 1000.0)));
+        hash = schedule_cache::combine(hash, static_cast<uint64_t>(config.midi.THIN_MAX_KEYS_PER_WINDOW));
+        hash = schedule_cache::combine(hash, static_cast<uint64_t>(std::llround(config.midi.THIN_SHORT_NOTE_MS * 1000.0)));
+    }
+    if (config.midi.DEDUP_NOTES)
+        hash = schedule_cache::combine(hash, static_cast<uint64_t>(std::llround(config.midi.DEDUP_WINDOW_MS * 1000.0)));
+    return hash;
+}
+
+void VirtualPianoPlayer::load_schedule(const MidiFile& mid, const std::filesystem::path& midi_path) {
+    stop_schedule();
+    schedule_cache::Key key;
+    if (!midi::Config::getInstance().midi.SCHEDULE_CACHE || !schedule_cache::hashFile(midi_path, key.content)) {
+        process_tracks(mid);
+        return;
+    }
+    key.settings = schedule_settings_hash();
+    std::filesystem::path cache_file = schedule_cache::pathFor(midi_path, key);
+
+    auto started = std::chrono::steady_clock::now();
+    schedule_cache::View cached;
+    if (cached.open(cache_file, key) && restore_cached_schedule(cached, mid)) {
+        tempo_map = TempoMap(mid);
+        schedule_settings = current_schedule_settings();
+        merged_events.clear();
+        merged_complete = false;
+        thinning_stats = {};
+        auto ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+        std::cout << "[Cache] Restored " << scheduled_events() << " scheduled events in "
+                  << std::fixed << std::setprecision(1) << ms << " ms\n";
+        return;
+    }
+    schedule_cache_key = key;
+    process_tracks(mid, std::move(cache_file));
+}
+
+bool VirtualPianoPlayer::restore_cached_schedule(const schedule_cache::View& cached, const MidiFile& mid) {
+    schedule_cache::ScheduleInfo info;
+    cached.readInfo(info);
+    const size_t track_count = mid.tracks.size();
+    const bool filterDrums = midi::Config::getInstance().midi.DETECT_DRUMS;
+    if (info.tracks.size() != track_count || (filterDrums && info.drumFlags.size() != track_count))
+        return false;
+
+    // The track list and details panel need only these; drum scores come from the
+    // cached flags, so the full feature scan waits until a reprocess wants it.
+    track_features.assign(track_count, TrackFeatures{});
+    for (size_t i = 0; i < track_count; ++i) {
+        TrackFeatures& f = track_features[i];
+        f.channelNoteOns = info.tracks[i].channelNoteOns;
+        for (uint32_t n : f.channelNoteOns)
+            f.noteOns += n;
+        f.program = info.tracks[i].program;
+        readTrackNames(mid.tracks[i], f);
+    }
+    track_features_partial = true;
+
+    tempo_changes = std::move(info.tempoChanges);
+    timeSignatures = std::move(info.timeSignatures);
+    if (filterDrums)
+        drum_flags = std::move(info.drumFlags);
+    else
+        drum_flags.clear();
+    schedule_end = std::chrono::nanoseconds(info.endNs);
+
+    // Records are packed to 16 bytes and NoteEvent is a padded 64, so they can't be
+    // played in place; one allocation and one linear pass turns them into events.
+    const auto records = cached.records();
+    reset_program();
+    {
+        std::lock_guard<std::mutex> lock(buffer_mutex);
+        reset_note_buffer(records.size());
+        event_pool.reset();
+        cached_events.reserve(records.size());
+        for (const auto& r : records) {
+            const bool sustain = r.note == schedule_cache::SUSTAIN_NOTE;
+            note_buffer[note_count++] = &cached_events.emplace_back(std::chrono::nanoseconds(r.timeNs),
+                sustain ? uint8_t(0) : r.note,
+                static_cast<EventType>(r.action), static_cast<int>(r.velocity),
+                sustain, static_cast<int>(r.sustainValue), schedule_cache::unpackTrack(r.trackIndex),
+                schedule_cache::unpackTrack(r.coveredBy));
+        }
+    }
+    scheduled_count.store(note_count, std::memory_order_release);
+    schedule_horizon_ns.store(std::numeric_limits<int64_t>::max(), std::memory_order_release);
+    schedule_done.store(true, std::memory_order_release);
+    schedule_cv.notify_all();
+    refresh_program();
+    return true;
+}
+
+void VirtualPianoPlayer::save_schedule_cache() {
+    const size_t count = scheduled_count.load(std::memory_order_acquire);
+    std::vector<schedule_cache::Record> records;
+    records.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        const NoteEvent& e = *note_buffer[i];
+        const uint8_t note = e.isSustain ? schedule_cache::SUSTAIN_NOTE : e.note;
+        records.push_back({ e.time.count(), schedule_cache::packTrack(e.trackIndex),
+                            schedule_cache::packTrack(e.coveredBy), note,
+                            static_cast<uint8_t>(e.action), static_cast<uint8_t>(e.velocity),
+                            static_cast<uint8_t>(e.sustainValue) });
+    }
+
+    schedule_cache::ScheduleInfo info;
+    info.endNs = schedule_end.count();
+    info.tempoChanges = tempo_changes;
+    info.timeSignatures = timeSignatures;
+    info.tracks.reserve(track_features.size());
+    for (const auto& features : track_features)
+        info.tracks.push_back({ features.channelNoteOns, features.program });
+    if (midi::Config::getInstance().midi.DETECT_DRUMS)
+        info.drumFlags = drum_flags;
+    if (schedule_cache::write(schedule_cache_file, schedule_cache_key, records, info))
+        std::cout << "[Cache] Saved schedule (" << count << " events) to " << schedule_cache_file.string() << "\n";
+    else
+        std::cout << "[Cache] Could not write " << schedule_cache_file.string() << "\n";
+}
+
+void VirtualPianoPlayer::append_schedule_event(std::chrono::nanoseconds time,
+                                               uint8_t note,
+                                               EventType action,
+                                               int velocity,
+                                               bool isSustain,
+                                               int sustainValue,
+                                               int trackIndex,
+                                               int coveredBy)
+{
+    // Only the slot is written; the playback thread learns of it through scheduled_count.
+    assert(note_count < note_capacity && "schedule bound too small");
+    if (note_count == note_capacity) {
+        if (!note_overflow)
+            std::cerr << "[Schedule] More events than the bound of " << note_capacity << "; the rest are lost\n";
+        note_overflow = true;
+        return;
+    }
+    note_buffer[note_count++] = event_pool.allocate(time, note, action, velocity,
+                                                    isSustain, sustainValue, trackIndex, coveredBy);
+    if (!hold_scheduled_count)
+        scheduled_count.store(note_count, std::memory_order_release);
+}
+
+void VirtualPianoPlayer::reset_note_buffer(size_t capacity) {
+    note_buffer = std::make_unique_for_overwrite<NoteEvent*[]>(capacity);
+    cached_events = {};   // only reachable through the old slots
+    note_capacity = capacity;
+    note_count = 0;
+    note_overflow = false;
+}
+
+void VirtualPianoPlayer::handle_note_off(std::chrono::nanoseconds ctime,
+                                         int ch,
+                                         int note,
+                                         int vel,
+                                         int trackIndex,
+                                         ScheduleBuild& build)
+{
+    using NH = midi::NoteHandlingMode;
+    const auto mode = build.note_mode;
+    if (mode == NH::NoHandling) {
+        build.duplicates.release(note, ctime);
+        add_note_event(ctime, note, EventType::Release, vel, trackIndex);
+        return;
+    }
+    // Only a note-off that closes an open note-on is scheduled.
+    const bool closed = (mode == NH::LIFO) ? build.active_notes.popNewest(ch, note)
+                                           : build.active_notes.popOldest(ch, note);
+    if (closed) {
+        build.duplicates.release(note, ctime);
+        add_note_event(ctime, note, EventType::Release, vel, trackIndex);
+    }
+}
+
+void VirtualPianoPlayer::handle_note_on(std::chrono::nanoseconds ctime,
+                                        int ch,
+                                        int note,
+                                        int vel,
+                                        int trackIndex,
+                                        ScheduleBuild& build)
+{
+    // NoHandling never pairs note-offs, so there is nothing to track.
+    if (build.note_mode != midi::NoteHandlingMode::NoHandling)
+        build.active_notes.push(ch, note, ctime);
+    add_note_event(ctime, note, EventType::Press, vel, trackIndex,
+                   build.duplicates.press(note, ctime, trackIndex));
+}
+
+void VirtualPianoPlayer::add_sustain_event(std::chrono::nanoseconds time,
+                                           int channel,
+                                           int sustainValue,
+                                           int trackIndex,
+                                           SustainCoalescer& pedals)
+{
+    if (!pedals.accept(trackIndex, channel, sustainValue))
+        return;
+    EventType et = (sustainValue >= g_sustainCutoff)
+                   ? EventType::Press
+                   : EventType::Release;
+    append_schedule_event(time, 0, et, 0, true, sustainValue & 0xFF, trackIndex);
+}
+
+void VirtualPianoPlayer::add_note_event(std::chrono::nanoseconds time,
+                                        int note,
+                                        EventType action,
+                                        int velocity,
+                                        int trackIndex,
+                                        int coveredBy)
+{
+    append_schedule_event(time, static_cast<uint8_t>(note & 0x7F), action, velocity, false, 0, trackIndex, coveredBy);
+}
+
+void VirtualPianoPlayer::speed_up() {
+    adjust_playback_speed(1.1);
+}
+
+void VirtualPianoPlayer::slow_down() {
+    adjust_playback_speed(1.0 / 1.1);
+}
+
+void VirtualPianoPlayer::adjust_playback_speed(double factor) {
+    uint64_t now_tsc = __rdtsc();
+    if (!playback_started.load(std::memory_order_relaxed)) {
+        // If playback hasn’t started, initialize TSC but don’t adjust time yet
+        playback_start_time = now_tsc;
+        last_resume_tsc     = now_tsc;
+    }
+    else {
+        // Calculate how much time has elapsed at current_speed
+        uint64_t tick_diff = now_tsc - last_resume_tsc;
+        // Convert to nanoseconds
+        double elapsed_ns = double(tick_diff) * cyclesToNs * current_speed;
+        total_adjusted_time += std::chrono::nanoseconds(
+            static_cast<std::chrono::nanoseconds::rep>(elapsed_ns + 0.5)
+        );
+        last_resume_tsc = now_tsc;
+    }
+
+    // Adjust the playback speed
+    current_speed *= factor;
+    current_speed = std::clamp(current_speed, 0.25, 2.0);
+    if (std::fabs(current_speed - 1.0) < 0.05) {
+        current_speed = 1.0; // Snap to normal speed if close
+    }
+
+    // Update time_factor to reflect the new speed
+    time_factor = cyclesToNs * current_speed;
+    std::cout << "[SPEED] x" << current_speed << "\n";
+}
+
+void VirtualPianoPlayer::arrowsend(WORD sc, bool extended) {
+    INPUT in[2] = {};
+    in[0].type      = INPUT_KEYBOARD;
+    in[0].ki.wScan  = sc;
+    in[0].ki.dwFlags= KEYEVENTF_SCANCODE | (extended ? KEYEVENTF_EXTENDEDKEY : 0);
+
+    in[1].type      = INPUT_KEYBOARD;
+    in[1].ki.wScan  = sc;
+    in[1].ki.dwFlags= KEYEVENTF_SCANCODE | KEYEVENTF_KEYUP
+                      | (extended ? KEYEVENTF_EXTENDEDKEY : 0);
+
+    sendInputs(in, 2);
+}
+
+void VirtualPianoPlayer::hotkey_listener() {
+    int playPauseVK     = stringToVK(midi::Config::getInstance().hotkeys.PLAY_PAUSE_KEY);
+    int rewindVK        = stringToVK(midi::Config::getInstance().hotkeys.REWIND_KEY);
+    int skipVK          = stringToVK(midi::Config::getInstance().hotkeys.SKIP_KEY);
+    int emergencyExitVK = stringToVK(midi::Config::getInstance().hotkeys.EMERGENCY_EXIT_KEY);
+    int noteModeVK      = stringToVK(midi::Config::getInstance().hotkeys.NOTE_MODE_KEY);
+    int drumDetectVK    = stringToVK(midi::Config::getInstance().hotkeys.DRUM_DETECT_KEY);
+
+    bool wasPlayPause   = false;
+    bool wasRewind      = false;
+    bool wasSkip        = false;
+    bool wasEmergency   = false;
+    bool wasNoteMode    = false;
+    bool wasDrumDetect  = false;
+
+    while (!hotkey_stop.load(std::memory_order_acquire)) {
+        bool playPauseDown  = (GetAsyncKeyState(playPauseVK) & 0x8000) != 0;
+        bool rewindDown     = (GetAsyncKeyState(rewindVK) & 0x8000) != 0;
+        bool skipDown       = (GetAsyncKeyState(skipVK) & 0x8000) != 0;
+        bool emergencyDown  = (GetAsyncKeyState(emergencyExitVK) & 0x8000) != 0;
+        bool noteModeDown   = (GetAsyncKeyState(noteModeVK) & 0x8000) != 0;
+        bool drumDetectDown = (GetAsyncKeyState(drumDetectVK) & 0x8000) != 0;
+
+        if (playPauseDown && !wasPlayPause) {
+            // std::cout << "[DEBUG] F1 pressed (PLAY/PAUSE)\n";
+            toggle_play_pause();
+        }
+        if (rewindDown && !wasRewind) {
+            // std::cout << "[DEBUG] F2 pressed (REWIND)\n";
+            rewind(std::chrono::seconds(10));
+        }
+        if (skipDown && !wasSkip) {
+            // std::cout << "[DEBUG] F3 pressed (SKIP)\n";
+            skip(std::chrono::seconds(10));
+        }
+        if (emergencyDown && !wasEmergency) {
+            // std::cout << "[DEBUG] F4 pressed (EMERGENCY EXIT)\n";
+            emergency_exit();
+        }
+        if (noteModeDown && !wasNoteMode)
+            cycle_note_handling_mode();
+        if (drumDetectDown && !wasDrumDetect)
+            toggle_drum_detection();
+
+        wasPlayPause  = playPauseDown;
+        wasRewind     = rewindDown;
+        wasSkip       = skipDown;
+        wasEmergency  = emergencyDown;
+        wasNoteMode   = noteModeDown;
+        wasDrumDetect = drumDetectDown;
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+}
+
+void VirtualPianoPlayer::emergency_exit() {
+    std::cout << "[EMERGENCY] Emergency exit triggered. Stopping playback and exiting.\n";
+    should_stop.store(true, std::memory_order_release);
+    release_all_keys();
+    signalPlayback();
+    std::exit(1);
+}
+
 void VirtualPianoPlayer::initializeKeyCache() {
     for (const auto& [note, key] : limited_key_mappings) {
         if (!key.empty() && g_keyCache.find(key) == g_keyCache.end()) {
@@ -1654,205 +2769,229 @@ void VirtualPianoPlayer::initializeKeyCache() {
             g_keyCache.emplace(key, computeKeySequence(key));
         }
     }
+    // Element pointers survive later g_keyCache insertions (velocity keys).
+    auto resolve = [](const std::map<std::string, std::string>& mappings, const std::string& name) -> const KeySequence* {
+        auto it = mappings.find(name);
+        return (it != mappings.end() && !it->second.empty()) ? &g_keyCache.at(it->second) : nullptr;
+    };
+    for (int n = 0; n < 128; ++n) {
+        const std::string name = get_note_name(n);
+        g_limitedNoteKeys[n] = resolve(limited_key_mappings, name);
+        g_fullNoteKeys[n] = resolve(full_key_mappings, name);
+    }
+}
+
+void VirtualPianoPlayer::execute_note_event(const NoteEvent& event) noexcept {
+    if (!isTrackEnabled(event.trackIndex))
+        return;
+    // A duplicate press only plays when the copy it doubles is muted.
+    if (event.coveredBy >= 0 && isTrackEnabled(event.coveredBy))
+        return;
+
+    if (!event.isSustain) {
+        if (event.action == EventType::Press) {
+            if (enable_volume_adjustment.load(std::memory_order_relaxed)) {
+                AdjustVolumeBasedOnVelocity(event.velocity);
+            }
+            if (enable_velocity_keypress.load(std::memory_order_relaxed) &&
+                event.velocity != 0)
+            {
+                std::string velocityKey = "alt+" + getVelocityKey(event.velocity);
+                if (velocityKey != lastPressedKey) {
+                    KeyPress(velocityKey, true);
+                    KeyPress(velocityKey, false);
+                    lastPressedKey = velocityKey;
+                    program_velocity_key = -1;
+                }
+            }
+            press_key(event.note);
+        }
+        else {
+            release_key(event.note);
+        }
+    }
+    else {
+        // handle sustain pedal event
+        handle_sustain_event(event);
+    }
+}
+
+void VirtualPianoPlayer::handle_sustain_event(const NoteEvent& event) {
+    switch (currentSustainMode) {
+    case SustainMode::IG:
+        return;
+
+    case SustainMode::SPACE_DOWN:
+        if (event.action == EventType::Press && !isSustainPressed) {
+            if (event.sustainValue >= g_sustainCutoff) {
+                pressKey(sustain_key_code);
+                isSustainPressed = true;
+            }
+        }
+        else if (event.action == EventType::Release && isSustainPressed) {
+            if (event.sustainValue < g_sustainCutoff) {
+                releaseKey(sustain_key_code);
+                isSustainPressed = false;
+            }
+        }
+        break;
+
+    case SustainMode::SPACE_UP:
+        if (event.action == EventType::Release && !isSustainPressed) {
+            if (event.sustainValue < g_sustainCutoff) {
+                pressKey(sustain_key_code);
+                isSustainPressed = true;
+            }
+        }
+        else if (event.action == EventType::Press && isSustainPressed) {
+            if (event.sustainValue >= g_sustainCutoff) {
+                releaseKey(sustain_key_code);
+                isSustainPressed = false;
+            }
+        }
+        break;
+    }
+}
+
+void VirtualPianoPlayer::toggle_play_pause() {
+    bool wasPaused = paused.load(std::memory_order_acquire);
+    if (wasPaused)
+        last_resume_tsc = __rdtsc();   // before the playback thread can see the resume
+    paused.store(!wasPaused, std::memory_order_release);
+    if (!wasPaused) {
+        // Pausing: once parked, the playback thread dispatches nothing more, so sustain releases cleanly.
+        wait_until_parked();
+        drain_injector();
+        release_all_keys();
+
+        uint64_t current_tsc = __rdtsc();
+        uint64_t tick_diff   = current_tsc - last_resume_tsc;
+        double elapsed_ns    = double(tick_diff) * cyclesToNs * current_speed;
+        total_adjusted_time += std::chrono::nanoseconds(
+            static_cast<std::chrono::nanoseconds::rep>(elapsed_ns + 0.5)
+        );
+
+        std::cout << "[PLAYBACK] Paused\n";
+        report_dispatch_latency();
+        report_event_lateness();
+        // Settings changed during playback take effect now.
+        reprocess_schedule();
+        refresh_program();
+    }
+    else {
+        // Resuming
+        signalPlayback();
+        std::cout << "[PLAYBACK] Resumed\n";
+    }
+
+    if (!playback_thread) {
+        playback_parked.store(false);
+        playback_thread = std::make_unique<std::jthread>(
+            &VirtualPianoPlayer::play_notes, this
+        );
+    }
+}
+
+void VirtualPianoPlayer::skip(std::chrono::seconds duration) {
+    release_all_keys();
+    auto skip_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(duration);
+
+    if (!playback_started.load(std::memory_order_acquire)) {
+        total_adjusted_time += skip_ns;
+        if (total_adjusted_time < std::chrono::nanoseconds(0)) {
+            total_adjusted_time = std::chrono::nanoseconds(0);
+        }
+        buffer_index.store(find_next_event_index(total_adjusted_time),
+                           std::memory_order_release);
+        return;
+    }
+
+    bool song_ended = playback_reached_end() &&
+                      playback_started.load(std::memory_order_acquire);
+
+    if (song_ended) {
+        restart_song();
+        total_adjusted_time += skip_ns;
+        if (total_adjusted_time < std::chrono::nanoseconds(0)) {
+            total_adjusted_time = std::chrono::nanoseconds(0);
+        }
+        buffer_index.store(find_next_event_index(total_adjusted_time),
+                           std::memory_order_release);
+        last_resume_tsc = __rdtsc();
+    }
+    else {
+        playback_control.requestSkip(duration);
+        signalPlayback();
+    }
+}
+
+void VirtualPianoPlayer::rewind(std::chrono::seconds duration) {
+    release_all_keys();
+    auto rewind_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(duration);
+
+    bool ended = playback_reached_end() &&
+                 playback_started.load(std::memory_order_acquire);
+
+    if (ended) {
+        should_stop.store(true, std::memory_order_release);
+        signalPlayback();
+        if (playback_thread && playback_thread->joinable()) {
+            playback_thread->join();
+        }
+        size_t scheduled = scheduled_events();
+        auto total_len = scheduled == 0
+                         ? std::chrono::nanoseconds(0)
+                         : note_buffer[scheduled - 1]->time;
+        total_adjusted_time = (rewind_ns > total_len)
+                             ? std::chrono::nanoseconds(0)
+                             : total_len - rewind_ns;
+        buffer_index.store(find_next_event_index(total_adjusted_time),
+                           std::memory_order_release);
+        paused.store(false, std::memory_order_release);
+        should_stop.store(false, std::memory_order_release);
+
+        last_resume_tsc = __rdtsc();
+        // re-launch playback thread
+        playback_parked.store(false);
+        playback_thread = std::make_unique<std::jthread>(
+            &VirtualPianoPlayer::play_notes, this
+        );
+    }
+    else {
+        playback_control.requestRewind(duration);
+        signalPlayback();
+    }
+}
+
+bool VirtualPianoPlayer::isTrackEnabled(int trackIndex) const {
+    if (trackIndex < 0 ||
+        trackIndex >= static_cast<int>(trackMuted.size()))
+    {
+        return true;
+    }
+    bool anySolo = false;
+    for (const auto& solo : trackSoloed) {
+        if (solo->load(std::memory_order_relaxed)) {
+            anySolo = true;
+            break;
+        }
+    }
+    if (anySolo) {
+        return trackSoloed[trackIndex]->load(std::memory_order_relaxed);
+    }
+    return !trackMuted[trackIndex]->load(std::memory_order_relaxed);
+}
+
+void VirtualPianoPlayer::set_track_mute(size_t trackIndex, bool mute) {
+    if (trackIndex < trackMuted.size()) {
+        trackMuted[trackIndex]->store(mute, std::memory_order_relaxed);
+        track_state_version.fetch_add(1, std::memory_order_release);
+    }
+}
+
+void VirtualPianoPlayer::set_track_solo(size_t trackIndex, bool solo) {
+    if (trackIndex < trackSoloed.size()) {
+        trackSoloed[trackIndex]->store(solo, std::memory_order_relaxed);
+        track_state_version.fetch_add(1, std::memory_order_release);
+    }
 }
-
-void VirtualPianoPlayer::execute_note_event(const NoteEvent& event) noexcept {
-    if (!isTrackEnabled(event.trackIndex))
-        return;
-
-    if (!event.isSustain) {
-        if (event.action == EventType::Press) {
-            if (enable_volume_adjustment.load(std::memory_order_relaxed)) {
-                AdjustVolumeBasedOnVelocity(event.velocity);
-            }
-            if (enable_velocity_keypress.load(std::memory_order_relaxed) &&
-                event.velocity != 0)
-            {
-                std::string velocityKey = "alt+" + getVelocityKey(event.velocity);
-                if (velocityKey != lastPressedKey) {
-                    KeyPress(velocityKey, true);
-                    KeyPress(velocityKey, false);
-                    lastPressedKey = velocityKey;
-                }
-            }
-            press_key(event.note);
-        }
-        else {
-            release_key(event.note);
-        }
-    }
-    else {
-        // handle sustain pedal event
-        handle_sustain_event(event);
-    }
-}
-
-void VirtualPianoPlayer::handle_sustain_event(const NoteEvent& event) {
-    switch (currentSustainMode) {
-    case SustainMode::IG:
-        return;
-
-    case SustainMode::SPACE_DOWN:
-        if (event.action == EventType::Press && !isSustainPressed) {
-            if (event.sustainValue >= g_sustainCutoff) {
-                pressKey(sustain_key_code);
-                isSustainPressed = true;
-            }
-        }
-        else if (event.action == EventType::Release && isSustainPressed) {
-            if (event.sustainValue < g_sustainCutoff) {
-                releaseKey(sustain_key_code);
-                isSustainPressed = false;
-            }
-        }
-        break;
-
-    case SustainMode::SPACE_UP:
-        if (event.action == EventType::Release && !isSustainPressed) {
-            if (event.sustainValue < g_sustainCutoff) {
-                pressKey(sustain_key_code);
-                isSustainPressed = true;
-            }
-        }
-        else if (event.action == EventType::Press && isSustainPressed) {
-            if (event.sustainValue >= g_sustainCutoff) {
-                releaseKey(sustain_key_code);
-                isSustainPressed = false;
-            }
-        }
-        break;
-    }
-}
-
-void VirtualPianoPlayer::toggle_play_pause() {
-    bool wasPaused = paused.load(std::memory_order_acquire);
-    paused.store(!wasPaused, std::memory_order_release);
-    if (!wasPaused) {
-        // Pausing
-        signalPlayback();
-        // small delay so the playback thread halts, preventing issues releasing sustain
-        std::this_thread::sleep_for(std::chrono::milliseconds(10));
-        release_all_keys();
-
-        uint64_t current_tsc = __rdtsc();
-        uint64_t tick_diff   = current_tsc - last_resume_tsc;
-        double elapsed_ns    = double(tick_diff) * cyclesToNs * current_speed;
-        total_adjusted_time += std::chrono::nanoseconds(
-            static_cast<std::chrono::nanoseconds::rep>(elapsed_ns + 0.5)
-        );
-
-        std::cout << "[PLAYBACK] Paused\n";
-    }
-    else {
-        // Resuming
-        last_resume_tsc = __rdtsc();
-        signalPlayback();
-        std::cout << "[PLAYBACK] Resumed\n";
-    }
-
-    if (!playback_thread) {
-        playback_thread = std::make_unique<std::jthread>(
-            &VirtualPianoPlayer::play_notes, this
-        );
-    }
-}
-
-void VirtualPianoPlayer::skip(std::chrono::seconds duration) {
-    release_all_keys();
-    auto skip_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(duration);
-
-    if (!playback_started.load(std::memory_order_acquire)) {
-        total_adjusted_time += skip_ns;
-        if (total_adjusted_time < std::chrono::nanoseconds(0)) {
-            total_adjusted_time = std::chrono::nanoseconds(0);
-        }
-        buffer_index.store(find_next_event_index(total_adjusted_time),
-                           std::memory_order_release);
-        return;
-    }
-
-    bool song_ended = (buffer_index.load(std::memory_order_acquire) >= note_buffer.size()) &&
-                      playback_started.load(std::memory_order_acquire);
-
-    if (song_ended) {
-        restart_song();
-        total_adjusted_time += skip_ns;
-        if (total_adjusted_time < std::chrono::nanoseconds(0)) {
-            total_adjusted_time = std::chrono::nanoseconds(0);
-        }
-        buffer_index.store(find_next_event_index(total_adjusted_time),
-                           std::memory_order_release);
-        last_resume_tsc = __rdtsc();
-    }
-    else {
-        playback_control.requestSkip(duration);
-        signalPlayback();
-    }
-}
-
-void VirtualPianoPlayer::rewind(std::chrono::seconds duration) {
-    release_all_keys();
-    auto rewind_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(duration);
-
-    bool ended = (buffer_index.load(std::memory_order_acquire) >= note_buffer.size()) &&
-                 playback_started.load(std::memory_order_acquire);
-
-    if (ended) {
-        should_stop.store(true, std::memory_order_release);
-        signalPlayback();
-        if (playback_thread && playback_thread->joinable()) {
-            playback_thread->join();
-        }
-        auto total_len = note_buffer.empty()
-                         ? std::chrono::nanoseconds(0)
-                         : note_buffer.back()->time;
-        total_adjusted_time = (rewind_ns > total_len)
-                             ? std::chrono::nanoseconds(0)
-                             : total_len - rewind_ns;
-        buffer_index.store(find_next_event_index(total_adjusted_time),
-                           std::memory_order_release);
-        paused.store(false, std::memory_order_release);
-        should_stop.store(false, std::memory_order_release);
-
-        last_resume_tsc = __rdtsc();
-        // re-launch playback thread
-        playback_thread = std::make_unique<std::jthread>(
-            &VirtualPianoPlayer::play_notes, this
-        );
-    }
-    else {
-        playback_control.requestRewind(duration);
-        signalPlayback();
-    }
-}
-
-bool VirtualPianoPlayer::isTrackEnabled(int trackIndex) const {
-    if (trackIndex < 0 ||
-        trackIndex >= static_cast<int>(trackMuted.size()))
-    {
-        return true;
-    }
-    bool anySolo = false;
-    for (const auto& solo : trackSoloed) {
-        if (solo->load(std::memory_order_relaxed)) {
-            anySolo = true;
-            break;
-        }
-    }
-    if (anySolo) {
-        return trackSoloed[trackIndex]->load(std::memory_order_relaxed);
-    }
-    return !trackMuted[trackIndex]->load(std::memory_order_relaxed);
-}
-
-void VirtualPianoPlayer::set_track_mute(size_t trackIndex, bool mute) {
-    if (trackIndex < trackMuted.size()) {
-        trackMuted[trackIndex]->store(mute, std::memory_order_relaxed);
-    }
-}
-
-void VirtualPianoPlayer::set_track_solo(size_t trackIndex, bool solo) {
-    if (trackIndex < trackSoloed.size()) {
-        trackSoloed[trackIndex]->store(solo, std::memory_order_relaxed);
-    }
-}
@@ -0,0 +1,73 @@
+#pragma once
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// The schedule compiled down to what SendInput receives: one step per timestamp
+// holding that instant's releases and presses as a ready INPUT span, already
+// ordered, transposed and mapped, with re-strikes, velocity keys and the sustain
+// pedal worked out by replaying the song from its start. Playback walks the steps
+// and makes one injection call each. A step is only used while the options it was
+// compiled with are in force and every track it touches is audible; otherwise its
+// events go through execute_note_event one at a time.
+struct PlaybackProgram {
+    struct Options {
+        bool fullKeys = true;              // 88-key mode
+        bool outOfRangeTranspose = false;
+        bool velocityKeys = false;
+        size_t velocityCurve = 0;
+        int sustainMode = 0;
+        int sustainCutoff = 0;
+
+        bool operator==(const Options&) const = default;
+    };
+
+    // A pressed_notes update, by key after transposition, and the source note it plays.
+    struct KeyOp {
+        uint8_t note;
+        uint8_t source;
+        bool press;
+    };
+
+    struct Step {
+        std::chrono::nanoseconds time;
+        uint64_t trackMask;        // bit (track % 64) of every track with an event here, or doubled by one
+        uint32_t firstEvent;       // note_buffer range of the step
+        uint32_t eventCount;
+        uint32_t firstInput;
+        uint32_t inputCount;
+        uint32_t firstKeyOp;
+        uint32_t keyOpCount;
+        int16_t velocityKeyBefore; // velocity key the replay had last tapped, -1 for none
+        bool sustainBefore;        // pedal state the replay had reached
+    };
+
+    Options options;
+    std::vector<Step> steps;
+    std::vector<INPUT> inputs;
+    std::vector<KeyOp> keyOps;
+    std::vector<std::string> velocityKeys;          // "alt+..." names, by index
+    std::vector<std::vector<INPUT>> velocityTaps;   // press and release of each
+    int16_t finalVelocityKey = -1;
+    bool finalSustain = false;
+
+    // First step starting at or after note_buffer index `event`.
+    [[nodiscard]] size_t stepAt(size_t event) const noexcept {
+        auto it = std::lower_bound(steps.begin(), steps.end(), event,
+                                   [](const Step& s, size_t e) { return s.firstEvent < e; });
+        return static_cast<size_t>(it - steps.begin());
+    }
+    [[nodiscard]] int16_t velocityKeyAfter(size_t step) const noexcept {
+        return step + 1 < steps.size() ? steps[step + 1].velocityKeyBefore : finalVelocityKey;
+    }
+    [[nodiscard]] bool sustainAfter(size_t step) const noexcept {
+        return step + 1 < steps.size() ? steps[step + 1].sustainBefore : finalSustain;
+    }
+};
@@ -1,318 +1,517 @@
-﻿#ifndef PLAYBACK_SYSTEM_HPP
-#define PLAYBACK_SYSTEM_HPP
-
-#ifndef NOMINMAX
-#define NOMINMAX
-#endif
-
-#pragma once
-
-// Windows headers
-#include <windows.h>
-#include <windowsx.h>
-#include <avrt.h>
-
-// Standard headers
-#include <atomic>
-#include <chrono>
-#include <cstdint>
-#include <exception>
-#include <future>
-#include <memory>
-#include <mutex>
-#include <stdexcept>
-#include <string>
-#include <string_view>
-#include <thread>
-#include <vector>
-#include <array>
-#include <map>
-#include <unordered_map>
-#include <set>
-#include <algorithm>
-#include <iostream>
-#include <iomanip>
-#include <sstream>
-#include <fstream>
-#include <condition_variable>
-
-// Project-specific headers
-#include "resource.h"
-#include "config.hpp"      // Contains midi::Config and configuration definitions
-#include "Transpose.h"
-#include "json.hpp"
-#include "midi_parser.h"
-#include "InputHeader.h"   // For NtUserSendInputCall and GetNtUserSendInputSyscallNumber
-#include "thread_pool.h"   // dp::thread_pool
-#include "timer.h"
-
-class VirtualPianoPlayer;
-extern VirtualPianoPlayer* g_player;
-
-// Global variables (definitions provided in CPP)
-extern double g_totalSongSeconds;
-extern int    g_sustainCutoff;
-
-// =====================================================
-// Sustain Mode Enumeration
-// =====================================================
-enum class SustainMode {
-    IG,
-    SPACE_DOWN,
-    SPACE_UP
-};
-
-// =====================================================
-// EventType: For note actions (Press/Release)
-// =====================================================
-enum class EventType : uint8_t {
-    Press,
-    Release
-};
-
-// =====================================================
-// NoteEvent: Represents an internal note or control event.
-// =====================================================
-struct alignas(64) NoteEvent {
-    std::chrono::nanoseconds time;
-    std::string_view note;    // e.g. "C4" or "sustain"
-    EventType action;         // Press or Release
-    int velocity;
-    bool isSustain;           // true if sustain pedal event
-    int sustainValue;
-    int trackIndex;
-
-    NoteEvent() noexcept;
-    NoteEvent(std::chrono::nanoseconds t, std::string_view n, EventType a, int v, bool s, int sv, int trackIdx) noexcept;
-    bool operator>(const NoteEvent& other) const noexcept;
-};
-
-// =====================================================
-// NoteEventPool: Fast allocator for NoteEvent objects.
-// =====================================================
-class alignas(64) NoteEventPool {
-public:
-    NoteEventPool();
-    ~NoteEventPool();
-
-    template<typename... Args>
-    NoteEvent* allocate(Args&&... args) {
-        if (reinterpret_cast<size_t>(current) + sizeof(NoteEvent) > reinterpret_cast<size_t>(end))
-            allocateNewBlock();
-        NoteEvent* event = new (current) NoteEvent(std::forward<Args>(args)...);
-        current += sizeof(NoteEvent);
-        allocated_count.fetch_add(1, std::memory_order_relaxed);
-        return event;
-    }
-    void reset();
-    size_t getAllocatedCount() const;
-private:
-    static constexpr size_t CACHE_LINE_SIZE = 64;
-    static constexpr size_t BLOCK_SIZE = 1024 * 1024; // 1 MB block
-
-    struct alignas(CACHE_LINE_SIZE) Block {
-        char data[BLOCK_SIZE];
-        Block* next;
-    };
-
-    Block* head;
-    char* current;
-    char* end;
-    std::atomic<size_t> allocated_count;
-
-    void allocateNewBlock();
-};
-
-// =====================================================
-// PlaybackControl: Controls skip/rewind/restart commands.
-// =====================================================
-class PlaybackControl {
-public:
-    enum class Command { NONE, SKIP, REWIND, RESTART };
-    struct State {
-        std::chrono::nanoseconds position{ 0 };
-        size_t event_index{ 0 };
-        bool needs_reset{ false };
-    };
-
-    void requestSkip(std::chrono::seconds amount);
-    void requestRewind(std::chrono::seconds amount);
-    bool hasCommand() const;
-    State processCommand(const State& current_state, double speed, size_t buffer_size);
-private:
-    mutable std::mutex mutex;
-    Command pending_command{ Command::NONE };
-    std::chrono::seconds command_amount{ 0 };
-    std::atomic<bool> command_processed{ true };
-};
-
-// ----------------------------------------------------
-// RawNoteEvent: Holds raw MIDI event data.
-// ----------------------------------------------------
-struct RawNoteEvent {
-    std::chrono::nanoseconds time;
-    std::string_view note_or_control;
-    EventType action;         // Converted to enum
-    int velocity;
-    int trackIndex;
-};
-
-// =====================================================
-// VirtualPianoPlayer: Main class for virtual piano playback.
-// =====================================================
-class VirtualPianoPlayer {
-public:
-    VirtualPianoPlayer() noexcept(false);
-    ~VirtualPianoPlayer();
-
-    // Track controls
-    void set_track_mute(size_t trackIndex, bool mute);
-    void set_track_solo(size_t trackIndex, bool solo);
-
-    // Playback controls
-    void toggle_play_pause();
-    void skip(std::chrono::seconds duration);
-    void rewind(std::chrono::seconds duration);
-    void restart_song();
-    void speed_up();
-    void slow_down();
-    void toggle_out_of_range_transpose();
-    void toggle_88_key_mode();
-    void toggle_velocity_keypress();
-    void toggle_volume_adjustment();
-    void toggleSustainMode();
-    int  toggle_transpose_adjustment();
-    // Other operations
-    void release_all_keys();
-    void calibrate_volume();
-    void process_tracks(const MidiFile& midi_file);
-
-    // Static handle for command event
-    static HANDLE command_event;
-
-    // Data members
-    std::vector<RawNoteEvent> note_events;
-    std::vector<std::string> string_storage;
-    std::vector<std::pair<double, double>> tempo_changes;
-    std::vector<TimeSignature> timeSignatures;
-    std::unique_ptr<std::jthread> playback_thread;
-    std::atomic<bool> eightyEightKeyModeActive{ true };
-
-    std::vector<std::shared_ptr<std::atomic<bool>>> trackMuted;
-    std::vector<std::shared_ptr<std::atomic<bool>>> trackSoloed;
-    std::atomic<bool> midiFileSelected{ false };
-    std::atomic<bool> should_stop{ false };
-    std::atomic<bool> paused{ true };
-    std::atomic<bool> playback_started{ false };
-    std::atomic<size_t> buffer_index{ 0 };
-
-    double current_speed{ 1.0 };
-    double paused_time = 0.0;
-    int currentTransposition = 0;
-    std::chrono::nanoseconds total_adjusted_time{ 0 };
-
-    // Returns current adjusted playback time.
-    std::chrono::nanoseconds get_adjusted_time() noexcept;
-
-    // Precomputed scan table for key mapping.
-    static const std::array<WORD, 256> SCAN_TABLE_AUTO;
-
-    MidiFile midi_file;
-    std::vector<NoteEvent*> note_buffer;
-
-    // Velocity functions
-    void setVelocityCurveIndex(size_t index);
-    std::string getVelocityCurveName(midi::VelocityCurveType curveType);
-    std::string getVelocityKey(int targetVelocity);
-
-    // Sustain settings
-    SustainMode currentSustainMode{ SustainMode::IG };
-    std::atomic<bool> enable_volume_adjustment{ false };
-    std::atomic<bool> enable_velocity_keypress{ false };
-
-    // Key mapping
-    std::map<std::string, std::string> limited_key_mappings;
-    std::map<std::string, std::string> full_key_mappings;
-    std::unordered_map<std::string, std::atomic<bool>> pressed_keys;
-    std::string lastPressedKey;
-    bool isSustainPressed{ false };
-    WORD sustain_key_code{ 0 };
-
-    bool ENABLE_OUT_OF_RANGE_TRANSPOSE{ false };
-
-    std::array<int, 128> volume_lookup;
-    WORD volume_up_key_code{ 0 };
-    WORD volume_down_key_code{ 0 };
-    WORD pause_key_code{ 0 };
-    WORD rewind_key_code{ 0 };
-    WORD skip_key_code{ 0 };
-    WORD emergency_exit_key_code{ 0 };
-    std::atomic<int> current_volume{ 0 };
-    std::atomic<int> max_volume{ 0 };
-    std::vector<bool> drum_flags;
-    std::unique_ptr<std::jthread> hotkey_thread;
-    std::atomic<bool> hotkey_stop{ false }; 
-    void hotkey_listener();
-    void emergency_exit();
-    bool isTrackEnabled(int trackIndex) const;
-    WORD vkToScanCode(int vk);
-    std::condition_variable playback_cv;
-    std::mutex playback_cv_mutex;
-    unsigned long long last_resume_tsc;
-    unsigned long long playback_start_time;
-
-private:
-    std::mutex buffer_mutex;
-    PlaybackControl playback_control;
-    UINT m_timerResolutionSet{ 0 };
-    double inv_cpu_freq;  // Optional for optimization
-    double time_factor;
-    // Static waitable timer shared by all instances.
-    static HANDLE waitable_timer;
-
-    // Thread pool for processing note events.
-    dp::thread_pool<> processing_pool;
-
-    // Helper to signal playback thread (notify condition variable and legacy event)
-    inline void signalPlayback() noexcept {
-        SetEvent(command_event);
-        playback_cv.notify_all();
-    }
-
-    // Core playback functions.
-    void play_notes();
-    void prepare_event_queue();
-    void execute_note_event(const NoteEvent& event) noexcept;
-    void handle_sustain_event(const NoteEvent& event);
-    size_t find_next_event_index(const std::chrono::nanoseconds& target_time);
-    void reset_volume();
-    void initializeKeyCache();
-    void KeyPress(std::string_view key, bool press);
-    int stringToVK(std::string_view keyName);
-    void sendVirtualKey(WORD vk, bool is_press);
-    void pressKey(WORD vk);
-    void releaseKey(WORD vk);
-    void press_key(std::string_view note) noexcept;
-    void release_key(std::string_view note) noexcept;
-    std::string transpose_note(std::string_view note);
-    int note_name_to_midi(std::string_view note_name);
-    std::string get_note_name(int midi_note);
-    void handle_note_off(std::chrono::nanoseconds ctime, int ch, int note, int vel, int trackIndex,
-        std::unordered_map<int, std::unordered_map<int, std::vector<std::chrono::nanoseconds>>>& active_notes);
-    void handle_note_on(std::chrono::nanoseconds ctime, int ch, int note, int vel, int trackIndex,
-        std::unordered_map<int, std::unordered_map<int, std::vector<std::chrono::nanoseconds>>>& active_notes);
-    void add_sustain_event(std::chrono::nanoseconds time, int channel, int sustainValue, int trackIndex);
-    void add_note_event(std::chrono::nanoseconds time, std::string_view note, EventType action, int velocity, int trackIndex);
-    void adjust_playback_speed(double factor);
-    void arrowsend(WORD scanCode, bool extended);
-    void precompute_volume_adjustments();
-    void AdjustVolumeBasedOnVelocity(int velocity) noexcept;
-    std::pair<std::map<std::string, std::string>, std::map<std::string, std::string>> define_key_mappings();
-    // Pool 
-    NoteEventPool event_pool;
-
-    TransposeEngine transposeEngine;
-    size_t currentVelocityCurveIndex = 0;
-};
-
-#endif // PLAYBACK_SYSTEM_HPP
+﻿#ifndef PLAYBACK_SYSTEM_HPP
+#define PLAYBACK_SYSTEM_HPP
+
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+
+#pragma once
+
+// Windows headers
+#include <windows.h>
+#include <windowsx.h>
+#include <avrt.h>
+
+// Standard headers
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include <array>
+#include <map>
+#include <unordered_map>
+#include <set>
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <fstream>
+#include <condition_variable>
+#include <filesystem>
+
+// Project-specific headers
+#include "resource.h"
+#include "config.hpp"      // Contains midi::Config and configuration definitions
+#include "Transpose.h"
+#include "json.hpp"
+#include "midi_parser.h"
+#include "NoteThinning.hpp"
+#include "PlaybackProgram.hpp"
+#include "PolyphonyLimiter.hpp"
+#include "InputHeader.h"   // For NtUserSendInputCall and GetNtUserSendInputSyscallNumber
+#include "thread_pool.h"   // dp::thread_pool
+#include "ActiveNotes.hpp"
+#include "Dispatch.hpp"
+#include "DuplicateNotes.hpp"
+#include "LatenessHistogram.hpp"
+#include "ScheduleCache.hpp"
+#include "SustainCoalescer.hpp"
+#include "TempoMap.hpp"
+#include "TimingProfile.hpp"
+#include "TrackFeatures.hpp"
+#include "timer.h"
+
+class VirtualPianoPlayer;
+extern VirtualPianoPlayer* g_player;
+struct KeySequence;   // INPUTs of one key press/release, defined in PlaybackCore.cpp
+
+// Global variables (definitions provided in CPP)
+extern double g_totalSongSeconds;
+extern int    g_sustainCutoff;
+
+// =====================================================
+// Sustain Mode Enumeration
+// =====================================================
+enum class SustainMode {
+    IG,
+    SPACE_DOWN,
+    SPACE_UP
+};
+
+// =====================================================
+// EventType: For note actions (Press/Release)
+// =====================================================
+enum class EventType : uint8_t {
+    Press,
+    Release
+};
+
+// =====================================================
+// NoteEvent: Represents an internal note or control event.
+// =====================================================
+struct alignas(64) NoteEvent {
+    std::chrono::nanoseconds time;
+    uint8_t note;             // MIDI note number; names are only made for display
+    EventType action;         // Press or Release
+    int velocity;
+    bool isSustain;           // true if sustain pedal event
+    int sustainValue;
+    int trackIndex;
+    int coveredBy;            // press duplicating one on this track; skipped while that track plays
+
+    NoteEvent() noexcept;
+    NoteEvent(std::chrono::nanoseconds t, uint8_t n, EventType a, int v, bool s, int sv, int trackIdx,
+              int covered = -1) noexcept;
+    bool operator>(const NoteEvent& other) const noexcept;
+};
+
+// =====================================================
+// MergedEvent: A note or CC64 message after the track merge and tick-to-time
+// conversion, before note pairing and sustain thresholding.
+// =====================================================
+struct MergedEvent {
+    std::chrono::nanoseconds time;
+    uint16_t track;
+    uint8_t status;
+    uint8_t data1;
+    uint8_t data2;
+};
+
+// =====================================================
+// NoteEventPool: Fast allocator for NoteEvent objects.
+// =====================================================
+class alignas(64) NoteEventPool {
+public:
+    NoteEventPool();
+    ~NoteEventPool();
+
+    template<typename... Args>
+    NoteEvent* allocate(Args&&... args) {
+        if (reinterpret_cast<size_t>(current) + sizeof(NoteEvent) > reinterpret_cast<size_t>(end))
+            allocateNewBlock();
+        NoteEvent* event = new (current) NoteEvent(std::forward<Args>(args)...);
+        current += sizeof(NoteEvent);
+        allocated_count.fetch_add(1, std::memory_order_relaxed);
+        return event;
+    }
+    void reset();
+    size_t getAllocatedCount() const;
+private:
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+    static constexpr size_t BLOCK_SIZE = 1024 * 1024; // 1 MB block
+
+    struct alignas(CACHE_LINE_SIZE) Block {
+        char data[BLOCK_SIZE];
+        Block* next;
+    };
+
+    Block* head;
+    char* current;
+    char* end;
+    std::atomic<size_t> allocated_count;
+
+    void allocateNewBlock();
+};
+
+// =====================================================
+// PlaybackControl: Controls skip/rewind/restart commands.
+// =====================================================
+class PlaybackControl {
+public:
+    enum class Command { NONE, SKIP, REWIND, RESTART, RESYNC };
+    struct State {
+        std::chrono::nanoseconds position{ 0 };
+        size_t event_index{ 0 };
+        bool needs_reset{ false };
+    };
+
+    void requestSkip(std::chrono::seconds amount);
+    void requestRewind(std::chrono::seconds amount);
+    // Re-find the current position after the schedule was rebuilt under the player.
+    void requestResync();
+    bool hasCommand() const;
+    State processCommand(const State& current_state, double speed, size_t buffer_size);
+private:
+    mutable std::mutex mutex;
+    Command pending_command{ Command::NONE };
+    std::chrono::seconds command_amount{ 0 };
+    std::atomic<bool> command_processed{ true };
+};
+
+// =====================================================
+// VirtualPianoPlayer: Main class for virtual piano playback.
+// =====================================================
+class VirtualPianoPlayer {
+public:
+    VirtualPianoPlayer() noexcept(false);
+    ~VirtualPianoPlayer();
+
+    // Track controls
+    void set_track_mute(size_t trackIndex, bool mute);
+    void set_track_solo(size_t trackIndex, bool solo);
+
+    // Playback controls
+    void toggle_play_pause();
+    void skip(std::chrono::seconds duration);
+    void rewind(std::chrono::seconds duration);
+    void restart_song();
+    void speed_up();
+    void slow_down();
+    void toggle_out_of_range_transpose();
+    void toggle_88_key_mode();
+    void toggle_velocity_keypress();
+    void toggle_volume_adjustment();
+    void toggleSustainMode();
+    // Flip a schedule setting, then reprocess_schedule the loaded song.
+    void cycle_note_handling_mode();
+    void toggle_drum_detection();
+    int  toggle_transpose_adjustment();
+    // Other operations
+    void release_all_keys();
+    void calibrate_volume();
+    // Builds the schedule; with a cache_file it is also saved there once complete.
+    void process_tracks(const MidiFile& midi_file, std::filesystem::path cache_file = {});
+    // process_tracks through the on-disk schedule cache (MIDI_SETTINGS.SCHEDULE_CACHE):
+    // a hit restores the finished schedule without touching midi_file's events.
+    void load_schedule(const MidiFile& midi_file, const std::filesystem::path& midi_path);
+    // Applies changed noteHandlingMode, DETECT_DRUMS/DRUM_THRESHOLD or sustain cutoff to the loaded
+    // song by redoing only the stages they feed. Runs while paused and keeps the
+    // playhead; during playback the change waits for the next pause, and while the
+    // schedule is still streaming in, the producer applies it once it finishes.
+    bool reprocess_schedule();
+
+    // Static handle for command event
+    static HANDLE command_event;
+
+    // Streaming schedule: process_tracks starts a producer that appends to
+    // note_buffer in time order; only the first scheduled_events() entries are valid.
+    size_t scheduled_events() const noexcept { return scheduled_count.load(std::memory_order_acquire); }
+    bool schedule_complete() const noexcept { return schedule_done.load(std::memory_order_acquire); }
+    bool playback_reached_end() const noexcept;
+    std::chrono::nanoseconds schedule_end_time() const noexcept { return schedule_end; }
+    void stop_schedule();
+
+    // Data members
+    std::vector<std::pair<double, double>> tempo_changes;
+    std::vector<TimeSignature> timeSignatures;
+    TempoMap tempo_map;   // of the loaded file; rebuilt by process_tracks and load_schedule
+    std::unique_ptr<std::jthread> playback_thread;
+    std::atomic<bool> eightyEightKeyModeActive{ true };
+
+    std::vector<std::shared_ptr<std::atomic<bool>>> trackMuted;
+    std::vector<std::shared_ptr<std::atomic<bool>>> trackSoloed;
+    std::atomic<bool> midiFileSelected{ false };
+    std::atomic<bool> should_stop{ false };
+    std::atomic<bool> paused{ true };
+    std::atomic<bool> playback_parked{ true };   // playback thread idle in its pause wait (or not running)
+    std::atomic<int> dispatch_holds{ 0 };        // live DispatchHolds; the playback thread parks as if paused
+    std::atomic<bool> playback_started{ false };
+    std::atomic<size_t> buffer_index{ 0 };
+
+    double current_speed{ 1.0 };
+    double paused_time = 0.0;
+    int currentTransposition = 0;
+    std::chrono::nanoseconds total_adjusted_time{ 0 };
+
+    // Returns current adjusted playback time.
+    std::chrono::nanoseconds get_adjusted_time() noexcept;
+
+    // Precomputed scan table for key mapping.
+    static const std::array<WORD, 256> SCAN_TABLE_AUTO;
+
+    MidiFile midi_file;
+    // Slots sized to the schedule's bound before it is built and written by index, so the
+    // storage never changes under the playback thread; scheduled_count is all it shares.
+    std::unique_ptr<NoteEvent*[]> note_buffer;
+    size_t note_capacity = 0;        // slots in note_buffer
+    size_t note_count = 0;           // slots filled by the producer, at least scheduled_count
+    bool note_overflow = false;      // the bound was too small; reported once per build
+
+    // Velocity functions
+    void setVelocityCurveIndex(size_t index);
+    std::string getVelocityCurveName(midi::VelocityCurveType curveType);
+    std::string getVelocityKey(int targetVelocity);
+
+    // Sustain settings
+    SustainMode currentSustainMode{ SustainMode::IG };
+    std::atomic<bool> enable_volume_adjustment{ false };
+    std::atomic<bool> enable_velocity_keypress{ false };
+
+    // Key mapping
+    std::map<std::string, std::string> limited_key_mappings;
+    std::map<std::string, std::string> full_key_mappings;
+    std::array<std::atomic<bool>, 128> pressed_notes{};   // by MIDI note, after out-of-range transpose
+    // What each source note went down on, so its release lifts that key even if the
+    // out-of-range transpose or the key layout changed while it was held.
+    std::array<std::atomic<const KeySequence*>, 128> held_sequences{};   // by source note; null while not held
+    std::array<std::atomic<uint8_t>, 128> held_keys{};                    // its pressed_notes index
+    std::string lastPressedKey;
+    bool isSustainPressed{ false };
+    WORD sustain_key_code{ 0 };
+
+    bool ENABLE_OUT_OF_RANGE_TRANSPOSE{ false };
+
+    std::array<int, 128> volume_lookup;
+    WORD volume_up_key_code{ 0 };
+    WORD volume_down_key_code{ 0 };
+    WORD pause_key_code{ 0 };
+    WORD rewind_key_code{ 0 };
+    WORD skip_key_code{ 0 };
+    WORD emergency_exit_key_code{ 0 };
+    std::atomic<int> current_volume{ 0 };
+    std::atomic<int> max_volume{ 0 };
+    std::vector<bool> drum_flags;
+    std::vector<TrackFeatures> track_features;   // per track of the loaded file, from one scan at load
+    bool track_features_partial = false;         // after a cache hit: only what the UI shows
+    thinning::Result thinning_stats;             // of the last thinned build; empty when THIN_NOTES is off
+    dispatch::Latency dispatch_latency;          // since playback last resumed; reported on pause
+    dispatch::InputCalls input_calls;            // likewise
+    timing::LatenessHistogram event_lateness;    // likewise, per injected event
+    std::unique_ptr<std::jthread> hotkey_thread;
+    std::atomic<bool> hotkey_stop{ false }; 
+    void hotkey_listener();
+    void emergency_exit();
+    bool isTrackEnabled(int trackIndex) const;
+    WORD vkToScanCode(int vk);
+    std::condition_variable playback_cv;
+    std::mutex playback_cv_mutex;
+    std::mutex reprocess_mutex;   // one reprocess_schedule at a time; a parked thread takes it to seek
+    std::atomic<bool> reprocess_pending{ false };   // set under reprocess_mutex for the producer to apply
+    bool reprocess_locked();
+    // After paused is set: blocks until the playback thread stopped reading note_buffer.
+    // False if playback resumed first.
+    bool wait_until_parked();
+    bool dispatch_stopped() const noexcept {
+        return paused.load() || dispatch_holds.load() > 0;
+    }
+    // Parks the playback thread and drains the injector for its lifetime, so a UI or
+    // hotkey thread can change the key and pedal state the dispatching thread owns.
+    struct DispatchHold {
+        explicit DispatchHold(VirtualPianoPlayer& player);
+        ~DispatchHold();
+        DispatchHold(const DispatchHold&) = delete;
+        DispatchHold& operator=(const DispatchHold&) = delete;
+        VirtualPianoPlayer& player;
+        std::lock_guard<std::mutex> serialize;   // one holder at a time
+    };
+    std::mutex dispatch_hold_mutex;
+    unsigned long long last_resume_tsc;
+    unsigned long long playback_start_time;
+
+private:
+    std::mutex buffer_mutex;
+    PlaybackControl playback_control;
+    UINT m_timerResolutionSet{ 0 };
+    double inv_cpu_freq;  // Optional for optimization
+    double time_factor;
+    // Static waitable timer shared by all instances.
+    static HANDLE waitable_timer;
+
+    // Thread pool for processing note events (DISPATCH_MODE POOL).
+    dp::thread_pool<> processing_pool;
+
+    // Due events of one batch, releases first; reused so dispatch never allocates.
+    std::vector<NoteEvent*> dispatch_batch;
+    dispatch::Mode dispatch_mode{ dispatch::Mode::Inline };   // read from the config as play_notes starts
+    timing::Profile latency_profile{ timing::Profile::Balanced };   // likewise
+    std::chrono::nanoseconds spin_guard{ 0 };   // wall time before each event spent spinning instead of sleeping
+    size_t input_batch_cap = 0;                 // INPUT_BATCH_CAP, read as play_notes starts
+
+    // Song time and speed as a batch is dispatched, read on the playback thread, which
+    // owns the clock. The sending thread moves `now` on by the TSC cycles since `tsc`
+    // to time the batch as its inputs really go out.
+    struct DispatchClock {
+        std::chrono::nanoseconds now;
+        double speed;
+        uint64_t tsc;
+    };
+
+    // DISPATCH_MODE INJECTOR: play_notes queues each batch to injector_thread.
+    struct InjectItem {
+        const NoteEvent* event;           // one event, or
+        const PlaybackProgram::Step* step;  // a compiled step of active_program
+        uint64_t readyTsc;        // nonzero on a batch's first item only
+        DispatchClock clock;      // meaningful on a batch's first item only
+        bool batchEnd;            // set on a batch's last item
+    };
+    std::unique_ptr<dispatch::SpscRing<InjectItem, 4096>> inject_ring;
+    std::unique_ptr<std::jthread> injector_thread;
+    std::atomic<uint64_t> inject_queued{ 0 };   // events pushed, written by play_notes only
+    std::atomic<uint64_t> inject_done{ 0 };     // events injected, written by the injector only
+    std::atomic<uint32_t> inject_signal{ 0 };   // bumped to wake the injector
+
+    // Compiled form of the finished schedule; null while it streams in or is rebuilt.
+    std::atomic<std::shared_ptr<const PlaybackProgram>> program;
+    std::atomic<uint32_t> program_version{ 0 };   // bumped whenever program is replaced
+    // play_notes' copy, swapped in between batches once the injector has drained.
+    std::shared_ptr<const PlaybackProgram> active_program;
+    uint32_t active_program_version = 0;
+    size_t program_cursor = 0;                    // step of the next due batch
+    // Pedal and velocity-key state (isSustainPressed, lastPressedKey and these two) belong to
+    // whichever thread dispatches; other threads change them only under a DispatchHold.
+    int16_t program_velocity_key = -1;            // velocity key last tapped by a step, -1 if unknown
+    uint32_t velocity_key_version = 0;            // active_program_version program_velocity_key refers to
+    std::vector<const PlaybackProgram::Step*> dispatch_steps;   // the batch, when the program covers it
+    std::atomic<uint32_t> track_state_version{ 0 };   // bumped by set_track_mute and set_track_solo
+    uint32_t track_state_seen = 0;
+    uint64_t disabled_tracks = 0;                 // bit (track % 64) of every silenced track
+
+    // Helper to signal playback thread (notify condition variable and legacy event)
+    inline void signalPlayback() noexcept {
+        SetEvent(command_event);
+        playback_cv.notify_all();
+    }
+
+    // Schedule producer state.
+    std::unique_ptr<std::jthread> schedule_thread;
+    std::atomic<size_t> scheduled_count{ 0 };
+    bool hold_scheduled_count{ false };   // producer only: post passes still rewrite note_buffer
+    std::atomic<int64_t> schedule_horizon_ns{ 0 };   // every MIDI event up to here is merged
+    std::atomic<bool> schedule_done{ true };
+    std::chrono::nanoseconds schedule_end{ 0 };
+    std::condition_variable schedule_cv;
+    std::mutex schedule_mutex;
+    std::filesystem::path schedule_cache_file;   // where produce_schedule saves; empty = nowhere
+    schedule_cache::Key schedule_cache_key;
+
+    // What the current schedule was built with, so reprocess_schedule knows which stage to redo.
+    struct ScheduleSettings {
+        midi::NoteHandlingMode noteMode{};
+        bool detectDrums = false;
+        double drumThreshold = 0.0;
+        int sustainCutoff = 0;
+    };
+    ScheduleSettings schedule_settings;
+    // State of one pass of the scheduling stage, from produce_schedule or rebuild_schedule.
+    struct ScheduleBuild {
+        midi::NoteHandlingMode note_mode;   // read once, so a mid-build change can't mix pairings
+        ActiveNoteTracker active_notes;
+        SustainCoalescer pedals;
+        DuplicateNoteFilter duplicates;
+    };
+    std::vector<MergedEvent> merged_events;   // the producer's merged stream, kept for re-pairing
+    bool merged_complete{ false };            // false after a cache hit or a stopped producer
+
+    // Core playback functions.
+    void play_notes();
+    void wait_for_event(std::chrono::nanoseconds song_wait);
+    void dispatch_due_events(uint64_t ready_tsc);
+    void run_dispatch_batch(const DispatchClock& clock) noexcept;
+    // Events of the batch being sent, timed against batch_clock once its inputs flush.
+    // Owned by whichever thread dispatches, like the pedal state.
+    DispatchClock batch_clock{};
+    std::vector<const NoteEvent*> batch_events;
+    void note_batch_event(const NoteEvent& event) noexcept;
+    bool collect_program_steps(size_t first, size_t last);
+    void run_program_step(const PlaybackProgram::Step& step) noexcept;
+    PlaybackProgram::Options current_program_options() const;
+    void compile_program();
+    void refresh_program();
+    void reset_program();
+    // Fresh, empty note_buffer of `capacity` slots; only while nothing reads it.
+    void reset_note_buffer(size_t capacity);
+    void inject_event(const NoteEvent& event) noexcept;
+    void start_injector();
+    void stop_injector();
+    void run_injector(std::stop_token stop);
+    void drain_injector() noexcept;
+    void begin_input_batch(const DispatchClock& clock) noexcept;
+    void end_input_batch() noexcept;
+    void report_dispatch_latency();
+    void report_event_lateness();
+    void produce_schedule(const MidiFile& mid, std::stop_token stop);
+    void wait_for_schedule(std::chrono::nanoseconds target);
+    bool restore_cached_schedule(const schedule_cache::View& cached, const MidiFile& mid);
+    void save_schedule_cache();
+    static uint64_t schedule_settings_hash();
+    static ScheduleSettings current_schedule_settings();
+    static ScheduleBuild start_schedule_build();
+    static void report_schedule_build(const ScheduleBuild& build);
+    void detect_drums();
+    void merge_events(const MidiFile& mid);
+    void rebuild_schedule();
+    void rethreshold_sustain();
+    static bool has_schedule_passes();
+    void finish_schedule_passes();
+    void thin_schedule();
+    void limit_polyphony();
+    void schedule_merged_event(const MergedEvent& evt, ScheduleBuild& build);
+    void close_active_notes(std::chrono::nanoseconds ctime, ActiveNoteTracker& active_notes);
+    void append_schedule_event(std::chrono::nanoseconds time, uint8_t note, EventType action,
+        int velocity, bool isSustain, int sustainValue, int trackIndex, int coveredBy = -1);
+    void execute_note_event(const NoteEvent& event) noexcept;
+    void handle_sustain_event(const NoteEvent& event);
+    size_t find_next_event_index(const std::chrono::nanoseconds& target_time);
+    void reset_volume();
+    void initializeKeyCache();
+    void KeyPress(std::string_view key, bool press);
+    int stringToVK(std::string_view keyName);
+    void sendVirtualKey(WORD vk, bool is_press);
+    void pressKey(WORD vk);
+    void releaseKey(WORD vk);
+    void press_key(int note) noexcept;
+    void release_key(int note) noexcept;
+    // Releases the key `note` is held on unless it is `keep`, and forgets it.
+    void lift_held_key(int note, const KeySequence* keep) noexcept;
+    static int transpose_note(int note) noexcept;
+    static std::string get_note_name(int midi_note);
+    void handle_note_off(std::chrono::nanoseconds ctime, int ch, int note, int vel, int trackIndex,
+        ScheduleBuild& build);
+    void handle_note_on(std::chrono::nanoseconds ctime, int ch, int note, int vel, int trackIndex,
+        ScheduleBuild& build);
+    void add_sustain_event(std::chrono::nanoseconds time, int channel, int sustainValue, int trackIndex,
+        SustainCoalescer& pedals);
+    void add_note_event(std::chrono::nanoseconds time, int note, EventType action, int velocity, int trackIndex,
+        int coveredBy = -1);
+    void adjust_playback_speed(double factor);
+    void arrowsend(WORD scanCode, bool extended);
+    void precompute_volume_adjustments();
+    void AdjustVolumeBasedOnVelocity(int velocity) noexcept;
+    std::pair<std::map<std::string, std::string>, std::map<std::string, std::string>> define_key_mappings();
+    // Pool 
+    NoteEventPool event_pool;
+    std::vector<NoteEvent> cached_events;   // a cache hit's schedule, in one allocation; never grown
+
+    TransposeEngine transposeEngine;
+    size_t currentVelocityCurveIndex = 0;
+};
+
+#endif // PLAYBACK_SYSTEM_HPP
@@ -0,0 +1,130 @@
+#include "PolyphonyLimiter.hpp"
+#include <algorithm>
+#include <array>
+
+namespace polyphony {
+
+    namespace {
+        struct Held {
+            bool down = false;
+            std::chrono::nanoseconds since{};
+            uint8_t velocity = 0;
+        };
+
+        // Keys pressed at `now` can't be released early: playback runs an instant's
+        // releases before its presses, so the release would land before the press.
+        int chooseVictim(const std::array<Held, 128>& keys, Policy policy, std::chrono::nanoseconds now) {
+            auto eligible = [&](int n) { return keys[n].down && keys[n].since < now; };
+            int victim = -1;
+            switch (policy) {
+            case Policy::Oldest:
+                for (int n = 0; n < 128; ++n) {
+                    if (eligible(n) && (victim < 0 || keys[n].since < keys[victim].since))
+                        victim = n;
+                }
+                break;
+            case Policy::Quietest:
+                for (int n = 0; n < 128; ++n) {
+                    if (!eligible(n))
+                        continue;
+                    if (victim < 0 || keys[n].velocity < keys[victim].velocity ||
+                        (keys[n].velocity == keys[victim].velocity && keys[n].since < keys[victim].since))
+                        victim = n;
+                }
+                break;
+            case Policy::LowestNotBass: {
+                int bass = -1;
+                for (int n = 0; n < 128; ++n) {
+                    if (!keys[n].down)
+                        continue;
+                    if (bass < 0) {
+                        bass = n;
+                        continue;
+                    }
+                    if (eligible(n)) {
+                        victim = n;
+                        break;
+                    }
+                }
+                // Nothing above the bass can go: the bass has to.
+                if (victim < 0 && bass >= 0 && eligible(bass))
+                    victim = bass;
+                break;
+            }
+            }
+            return victim;
+        }
+    }
+
+    bool policyFromName(std::string_view name, Policy& policy) noexcept {
+        if (name == "OLDEST")
+            policy = Policy::Oldest;
+        else if (name == "QUIETEST")
+            policy = Policy::Quietest;
+        else if (name == "LOWEST_NOT_BASS")
+            policy = Policy::LowestNotBass;
+        else
+            return false;
+        return true;
+    }
+
+    Result limit(std::span<const Event> events, uint32_t maxHeld, Policy policy) {
+        Result result;
+        std::array<Held, 128> keys{};
+        uint32_t held = 0;      // keys down after stealing
+        uint32_t wanted = 0;    // keys the schedule would hold without stealing
+        std::array<bool, 128> wantedDown{};
+
+        for (size_t first = 0; first < events.size();) {
+            size_t last = first;
+            while (last < events.size() && events[last].time == events[first].time)
+                ++last;
+
+            // Playback runs an instant's releases before its presses.
+            for (size_t i = first; i < last; ++i) {
+                const Event& e = events[i];
+                if (e.press)
+                    continue;
+                if (keys[e.note].down) {
+                    keys[e.note].down = false;
+                    --held;
+                }
+                if (wantedDown[e.note]) {
+                    wantedDown[e.note] = false;
+                    --wanted;
+                }
+            }
+            for (size_t i = first; i < last; ++i) {
+                const Event& e = events[i];
+                if (!e.press)
+                    continue;
+                if (!wantedDown[e.note]) {
+                    wantedDown[e.note] = true;
+                    result.peakRequested = std::max(result.peakRequested, ++wanted);
+                }
+                Held& key = keys[e.note];
+                if (key.down) {
+                    // A re-strike; the key stays down as a fresh press.
+                    key.since = e.time;
+                    key.velocity = e.velocity;
+                    continue;
+                }
+                if (maxHeld > 0 && held >= maxHeld) {
+                    const int victim = chooseVictim(keys, policy, e.time);
+                    if (victim < 0) {
+                        // A chord wider than the limit: its extra notes don't sound.
+                        result.droppedPresses.push_back(i);
+                        continue;
+                    }
+                    keys[victim].down = false;
+                    --held;
+                    result.releases.push_back({ i, static_cast<uint8_t>(victim) });
+                }
+                key = { true, e.time, e.velocity };
+                ++held;
+            }
+            first = last;
+        }
+        return result;
+    }
+}
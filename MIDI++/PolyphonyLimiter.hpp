@@ -0,0 +1,44 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+// Caps how many keys the schedule holds down at once. Walks the schedule the way
+// playback does (releases of an instant before its presses, a press of a held key
+// re-strikes it) and, when a press would exceed the limit, releases a held key
+// early according to the stealing policy. The result is a list of releases to
+// insert, so playback itself stays a walk over a flat array.
+namespace polyphony {
+
+    enum class Policy {
+        Oldest,          // the key held longest
+        Quietest,        // the softest press, oldest on a tie
+        LowestNotBass    // the lowest key above the bass note, keeping the bass and melody
+    };
+
+    // "OLDEST", "QUIETEST" or "LOWEST_NOT_BASS"; false for anything else.
+    [[nodiscard]] bool policyFromName(std::string_view name, Policy& policy) noexcept;
+
+    // One key event of the schedule, in time order.
+    struct Event {
+        std::chrono::nanoseconds time;
+        uint8_t note;
+        uint8_t velocity;
+        bool press;
+    };
+
+    struct EarlyRelease {
+        size_t before;                 // index of the press that needed the key
+        uint8_t note;                  // key to release
+    };
+
+    struct Result {
+        std::vector<EarlyRelease> releases;
+        std::vector<size_t> droppedPresses;   // presses of a chord wider than the limit
+        uint32_t peakRequested = 0;    // most keys the schedule held at once without the limit
+    };
+
+    [[nodiscard]] Result limit(std::span<const Event> events, uint32_t maxHeld, Policy policy);
+}
@@ -0,0 +1,191 @@
+#include "ScheduleCache.hpp"
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <system_error>
+
+namespace schedule_cache {
+
+    namespace {
+        constexpr char MAGIC[8] = { 'M', 'I', 'D', 'I', 'P', 'P', 'S', 'C' };
+
+        struct FileHeader {
+            char magic[8];
+            uint32_t version;
+            uint32_t recordSize;
+            uint64_t contentHash;
+            uint64_t settingsHash;
+            uint64_t recordCount;
+            uint32_t tempoCount;
+            uint32_t timeSignatureCount;
+            uint32_t trackCount;          // drum flags
+            uint32_t summaryCount;
+            int64_t endNs;
+        };
+        static_assert(sizeof(FileHeader) == 64, "FileHeader is written to disk as-is");
+
+        struct CachedTempo {
+            double tick;
+            double microsecondsPerQuarter;
+        };
+
+        // Layout: header, records, tempo changes, time signatures, track summaries, one byte per track.
+        size_t expectedSize(const FileHeader& h) noexcept {
+            return sizeof(FileHeader) + h.recordCount * sizeof(Record) + h.tempoCount * sizeof(CachedTempo) +
+                h.timeSignatureCount * sizeof(CachedTimeSignature) + h.summaryCount * sizeof(TrackSummary) +
+                h.trackCount;
+        }
+
+        inline uint64_t mixWord(uint64_t hash, uint64_t word) noexcept {
+            hash ^= word;
+            hash *= 0x9E3779B97F4A7C15ULL;
+            return hash ^ (hash >> 29);
+        }
+    }
+
+    bool hashFile(const std::filesystem::path& path, uint64_t& hash) {
+        MappedFile mapped;
+        if (!mapped.open(path))
+            return false;
+        const char* data = mapped.data();
+        const size_t size = mapped.size();
+        // Four independent lanes keep the multiplies from serialising on one another.
+        uint64_t lanes[4] = { 0x243F6A8885A308D3ULL, 0x13198A2E03707344ULL, 0xA4093822299F31D0ULL, 0x082EFA98EC4E6C89ULL };
+        size_t pos = 0;
+        for (; pos + 32 <= size; pos += 32) {
+            for (int lane = 0; lane < 4; ++lane) {
+                uint64_t word;
+                std::memcpy(&word, data + pos + lane * 8, sizeof(word));
+                lanes[lane] = mixWord(lanes[lane], word);
+            }
+        }
+        uint64_t tail = 0;
+        std::memcpy(&tail, data + pos, size - pos < sizeof(tail) ? size - pos : sizeof(tail));
+        uint64_t h = mixWord(size, tail);
+        for (pos += sizeof(tail); pos < size; ++pos)
+            h = mixWord(h, static_cast<uint8_t>(data[pos]));
+        for (uint64_t lane : lanes)
+            h = mixWord(h, lane);
+        hash = h;
+        return true;
+    }
+
+    uint64_t combine(uint64_t hash, uint64_t value) noexcept {
+        return mixWord(hash, value);
+    }
+
+    std::filesystem::path pathFor(const std::filesystem::path& midiPath, const Key& key) {
+        std::ostringstream name;
+        name << std::hex << std::setfill('0') << std::setw(16) << key.content << '-'
+             << std::setw(16) << key.settings << ".sched";
+        return midiPath.parent_path() / ".midipp_cache" / name.str();
+    }
+
+    bool write(const std::filesystem::path& path, const Key& key,
+        std::span<const Record> records, const ScheduleInfo& info) {
+        std::error_code ec;
+        std::filesystem::create_directories(path.parent_path(), ec);
+        if (ec)
+            return false;
+
+        FileHeader header{};
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = FORMAT_VERSION;
+        header.recordSize = sizeof(Record);
+        header.contentHash = key.content;
+        header.settingsHash = key.settings;
+        header.recordCount = records.size();
+        header.tempoCount = static_cast<uint32_t>(info.tempoChanges.size());
+        header.timeSignatureCount = static_cast<uint32_t>(info.timeSignatures.size());
+        header.trackCount = static_cast<uint32_t>(info.drumFlags.size());
+        header.summaryCount = static_cast<uint32_t>(info.tracks.size());
+        header.endNs = info.endNs;
+
+        std::filesystem::path temp = path;
+        temp += ".tmp";
+        {
+            std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+            if (!out)
+                return false;
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            out.write(reinterpret_cast<const char*>(records.data()), records.size_bytes());
+            for (const auto& [tick, tempo] : info.tempoChanges) {
+                const CachedTempo entry{ tick, tempo };
+                out.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+            }
+            for (const auto& ts : info.timeSignatures) {
+                const CachedTimeSignature entry{ ts.tick, ts.numerator, ts.denominator,
+                    ts.clocksPerClick, ts.thirtySecondNotesPerQuarter };
+                out.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+            }
+            out.write(reinterpret_cast<const char*>(info.tracks.data()), info.tracks.size() * sizeof(TrackSummary));
+            for (bool drums : info.drumFlags)
+                out.put(drums ? 1 : 0);
+            if (!out.flush()) {
+                out.close();
+                std::filesystem::remove(temp, ec);
+                return false;
+            }
+        }
+        std::filesystem::rename(temp, path, ec);
+        if (ec) {
+            std::filesystem::remove(temp, ec);
+            return false;
+        }
+        return true;
+    }
+
+    bool View::open(const std::filesystem::path& path, const Key& key) {
+        recordData = nullptr;
+        recordCount = 0;
+        if (!file.open(path))
+            return false;
+        if (file.size() < sizeof(FileHeader)) {
+            file.close();
+            return false;
+        }
+        FileHeader header;
+        std::memcpy(&header, file.data(), sizeof(header));
+        if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != FORMAT_VERSION ||
+            header.recordSize != sizeof(Record) || header.contentHash != key.content ||
+            header.settingsHash != key.settings || expectedSize(header) != file.size()) {
+            file.close();
+            return false;
+        }
+        // The view is page-aligned and the header is 64 bytes, so the records are aligned too.
+        recordData = reinterpret_cast<const Record*>(file.data() + sizeof(FileHeader));
+        recordCount = static_cast<size_t>(header.recordCount);
+        return true;
+    }
+
+    void View::readInfo(ScheduleInfo& info) const {
+        FileHeader header;
+        std::memcpy(&header, file.data(), sizeof(header));
+        const char* p = file.data() + sizeof(FileHeader) + recordCount * sizeof(Record);
+
+        info.endNs = header.endNs;
+        info.tempoChanges.clear();
+        info.tempoChanges.reserve(header.tempoCount);
+        for (uint32_t i = 0; i < header.tempoCount; ++i, p += sizeof(CachedTempo)) {
+            CachedTempo entry;
+            std::memcpy(&entry, p, sizeof(entry));
+            info.tempoChanges.emplace_back(entry.tick, entry.microsecondsPerQuarter);
+        }
+        info.timeSignatures.clear();
+        info.timeSignatures.reserve(header.timeSignatureCount);
+        for (uint32_t i = 0; i < header.timeSignatureCount; ++i, p += sizeof(CachedTimeSignature)) {
+            CachedTimeSignature entry;
+            std::memcpy(&entry, p, sizeof(entry));
+            info.timeSignatures.push_back({ entry.tick, entry.numerator, entry.denominator,
+                entry.clocksPerClick, entry.thirtySecondNotesPerQuarter });
+        }
+        info.tracks.resize(header.summaryCount);
+        if (header.summaryCount > 0)
+            std::memcpy(info.tracks.data(), p, header.summaryCount * sizeof(TrackSummary));
+        p += header.summaryCount * sizeof(TrackSummary);
+        info.drumFlags.assign(header.trackCount, false);
+        for (uint32_t i = 0; i < header.trackCount; ++i)
+            info.drumFlags[i] = p[i] != 0;
+    }
+}
@@ -0,0 +1,108 @@
+#pragma once
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <utility>
+#include <vector>
+#include "mapped_file.h"
+#include "midi_structures.h"
+
+// On-disk copy of a finished playback schedule, so reloading a song skips the
+// merge, tick conversion, drum detection and the per-track feature scan. Files live in a ".midipp_cache"
+// folder next to the MIDI file and are named after the content hash and the
+// hash of every setting that changes what process_tracks produces.
+namespace schedule_cache {
+
+    // 2: times come from TempoMap's exact segments instead of truncated ns per tick.
+    // 3: notes left open at the end are released by number instead of as C0.
+    // 4: records carry the track a duplicate press defers to.
+    // 5: per-track summaries for the track list and details panel.
+    constexpr uint32_t FORMAT_VERSION = 5;
+
+    // Note number used for sustain pedal entries.
+    constexpr uint8_t SUSTAIN_NOTE = 0xFF;
+    // Track index stored for "no track"; a MIDI file has at most 0xFFFF tracks, indexed below this.
+    constexpr uint16_t NO_TRACK = 0xFFFF;
+
+    // NoteEvent's track fields (-1 for none) as stored, and back.
+    [[nodiscard]] constexpr uint16_t packTrack(int index) noexcept {
+        return index < 0 ? NO_TRACK : static_cast<uint16_t>(index);
+    }
+    [[nodiscard]] constexpr int unpackTrack(uint16_t index) noexcept {
+        return index == NO_TRACK ? -1 : static_cast<int>(index);
+    }
+
+    struct Key {
+        uint64_t content = 0;    // hash of the MIDI file bytes
+        uint64_t settings = 0;   // hash of the processing settings
+    };
+
+    // One schedule entry; NoteEvent without its cache-line padding.
+    struct Record {
+        int64_t timeNs;
+        uint16_t trackIndex;     // or NO_TRACK for the releases that close the song
+        uint16_t coveredBy;      // track of the press this duplicates, or NO_TRACK
+        uint8_t note;            // MIDI note number, or SUSTAIN_NOTE
+        uint8_t action;          // EventType
+        uint8_t velocity;
+        uint8_t sustainValue;
+    };
+    static_assert(sizeof(Record) == 16, "Record is written to disk as-is");
+
+    struct CachedTimeSignature {
+        uint32_t tick;
+        uint8_t numerator;
+        uint8_t denominator;
+        uint8_t clocksPerClick;
+        uint8_t thirtySecondNotesPerQuarter;
+    };
+    static_assert(sizeof(CachedTimeSignature) == 8, "CachedTimeSignature is written to disk as-is");
+
+    // The parts of TrackFeatures the UI shows; names are read back from the MIDI file.
+    struct TrackSummary {
+        std::array<uint32_t, 16> channelNoteOns;
+        int32_t program;         // -1 if none
+        bool operator==(const TrackSummary&) const = default;
+    };
+    static_assert(sizeof(TrackSummary) == 68, "TrackSummary is written to disk as-is");
+
+    // Everything process_tracks leaves behind besides note_buffer itself.
+    struct ScheduleInfo {
+        int64_t endNs = 0;
+        std::vector<std::pair<double, double>> tempoChanges;
+        std::vector<TimeSignature> timeSignatures;
+        std::vector<TrackSummary> tracks;
+        std::vector<bool> drumFlags;
+    };
+
+    // 64-bit hash of a whole file, read through a mapping. False if it can't be opened.
+    [[nodiscard]] bool hashFile(const std::filesystem::path& path, uint64_t& hash);
+    // Folds one more value into a settings hash.
+    [[nodiscard]] uint64_t combine(uint64_t hash, uint64_t value) noexcept;
+    [[nodiscard]] std::filesystem::path pathFor(const std::filesystem::path& midiPath, const Key& key);
+
+    // Writes through a temporary file and renames it, so a crash never leaves a torn cache.
+    [[nodiscard]] bool write(const std::filesystem::path& path, const Key& key,
+        std::span<const Record> records, const ScheduleInfo& info);
+
+    // A cache file mapped read-only; records() points straight into the view.
+    class View {
+    public:
+        // False on a missing, truncated or mismatched file.
+        [[nodiscard]] bool open(const std::filesystem::path& path, const Key& key);
+
+        [[nodiscard]] std::span<const Record> records() const noexcept { return { recordData, recordCount }; }
+        // Decodes the small tables stored after the records.
+        void readInfo(ScheduleInfo& info) const;
+
+    private:
+        MappedFile file;
+        const Record* recordData = nullptr;
+        size_t recordCount = 0;
+    };
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Reduces CC64 streams to the messages that move the pedal across the cutoff,
+// per track and channel. Continuous pedals send dozens of values per press;
+// only the crossings change what playback does. With hysteresis a pressed
+// pedal lifts only once the value drops below cutoff - hysteresis, so jitter
+// around the cutoff doesn't turn into press/release pairs.
+class SustainCoalescer {
+public:
+    SustainCoalescer(bool enabled, int cutoff, int hysteresis) noexcept
+        : enabled(enabled), cutoff(cutoff), releaseBelow(cutoff - hysteresis) {}
+
+    // True if this value should be scheduled. Every pedal starts up.
+    bool accept(int track, int channel, int value) {
+        ++seen;
+        if (!enabled)
+            return true;
+        if (track < 0)
+            track = 0;
+        if (static_cast<std::size_t>(track) >= down.size())
+            down.resize(static_cast<std::size_t>(track) + 1);
+        bool& pedal = down[track][channel & 0x0F];
+        const bool nowDown = pedal ? value >= releaseBelow : value >= cutoff;
+        if (nowDown == pedal) {
+            ++dropped;
+            return false;
+        }
+        pedal = nowDown;
+        return true;
+    }
+
+    [[nodiscard]] uint64_t seenCount() const noexcept { return seen; }
+    [[nodiscard]] uint64_t droppedCount() const noexcept { return dropped; }
+
+private:
+    bool enabled;
+    int cutoff;
+    int releaseBelow;
+    std::vector<std::array<bool, 16>> down;   // by track, then channel
+    uint64_t seen = 0;
+    uint64_t dropped = 0;
+};
@@ -0,0 +1,120 @@
+#include "TempoMap.hpp"
+#include <algorithm>
+#include <limits>
+
+TempoMap::TempoMap(const MidiFile& mid) {
+    segments.clear();
+    meters.clear();
+
+    uint64_t quarter;   // ticks per quarter note, for bars and beats
+    if (mid.division & 0x8000) {
+        const int fps = -static_cast<int8_t>(mid.division >> 8);
+        const uint64_t tpf = mid.division & 0xFF;
+        denominator = std::max<uint64_t>(1, fps > 0 ? fps * tpf : 0);
+        segments.push_back({ 0, 1000000000ULL, 0, 0 });
+        // SMPTE time has no beats; count quarters at 120 bpm.
+        quarter = std::max<uint64_t>(1, denominator / 2);
+    }
+    else {
+        denominator = std::max<uint64_t>(1, mid.division);
+        quarter = denominator;
+        // default 120 bpm if no tempo is set
+        segments.push_back({ 0, 500000ULL * 1000ULL, 0, 0 });
+        std::vector<TempoChange> sorted(mid.tempoChanges);
+        std::stable_sort(sorted.begin(), sorted.end(),
+                         [](const TempoChange& a, const TempoChange& b) { return a.tick < b.tick; });
+        for (const auto& tc : sorted) {
+            const uint64_t perTick = std::max<uint64_t>(1, tc.microsecondsPerQuarter) * 1000ULL;
+            Segment& last = segments.back();
+            if (tc.tick == last.tick) {
+                // Later of two tempo events on one tick wins.
+                last.perTick = perTick;
+                continue;
+            }
+            const uint64_t dt = tc.tick - last.tick;
+            const uint64_t frac = dt * (last.perTick % denominator) + last.rem;
+            segments.push_back({ tc.tick, perTick,
+                                 last.ns + dt * (last.perTick / denominator) + frac / denominator,
+                                 frac % denominator });
+        }
+    }
+
+    meters.push_back({ 0, 0, static_cast<uint32_t>(quarter), 4 });
+    std::vector<TimeSignature> signatures(mid.timeSignatures);
+    std::stable_sort(signatures.begin(), signatures.end(),
+                     [](const TimeSignature& a, const TimeSignature& b) { return a.tick < b.tick; });
+    for (const auto& ts : signatures) {
+        const uint32_t ticksPerBeat = static_cast<uint32_t>(
+            std::max<uint64_t>(1, quarter * 4 / std::max<uint8_t>(1, ts.denominator)));
+        const uint32_t beatsPerBar = std::max<uint32_t>(1, ts.numerator);
+        Meter& last = meters.back();
+        if (ts.tick == last.tick) {
+            last.ticksPerBeat = ticksPerBeat;
+            last.beatsPerBar = beatsPerBar;
+            continue;
+        }
+        const uint64_t barTicks = static_cast<uint64_t>(last.ticksPerBeat) * last.beatsPerBar;
+        const uint64_t bars = (ts.tick - last.tick + barTicks - 1) / barTicks;
+        meters.push_back({ ts.tick, last.bar + bars, ticksPerBeat, beatsPerBar });
+    }
+}
+
+std::chrono::nanoseconds TempoMap::timeIn(const Segment& seg, uint64_t tick) const noexcept {
+    // Split perTick so dt * perTick can't overflow: the quotient part is exact
+    // nanoseconds, the remainder part stays below dt * denominator.
+    const uint64_t dt = tick - seg.tick;
+    const uint64_t frac = dt * (seg.perTick % denominator) + seg.rem;
+    return std::chrono::nanoseconds(seg.ns + dt * (seg.perTick / denominator) + frac / denominator);
+}
+
+size_t TempoMap::segmentFor(uint64_t tick) const noexcept {
+    auto it = std::upper_bound(segments.begin(), segments.end(), tick,
+                               [](uint64_t t, const Segment& s) { return t < s.tick; });
+    return static_cast<size_t>(it - segments.begin()) - 1;
+}
+
+std::chrono::nanoseconds TempoMap::toTime(uint64_t tick) const noexcept {
+    return timeIn(segments[segmentFor(tick)], tick);
+}
+
+uint64_t TempoMap::toTick(std::chrono::nanoseconds time) const noexcept {
+    if (time.count() <= 0)
+        return 0;
+    const uint64_t t = static_cast<uint64_t>(time.count());
+    auto it = std::upper_bound(segments.begin(), segments.end(), t,
+                               [](uint64_t v, const Segment& s) { return v < s.ns; });
+    const Segment& seg = *(it - 1);
+
+    // Largest dt with floor((rem + dt * perTick) / denominator) <= t - ns, i.e.
+    // dt * perTick <= (d + 1) * denominator - rem - 1, evaluated without overflow.
+    const uint64_t d1 = t - seg.ns + 1;
+    const uint64_t qd = d1 / seg.perTick;
+    const uint64_t rd = d1 % seg.perTick;
+    if (qd > std::numeric_limits<uint64_t>::max() / denominator)
+        return std::numeric_limits<uint64_t>::max();
+    const int64_t m = static_cast<int64_t>(rd * denominator) - static_cast<int64_t>(seg.rem) - 1;
+    const int64_t p = static_cast<int64_t>(seg.perTick);
+    const int64_t floorPart = m >= 0 ? m / p : -((-m + p - 1) / p);
+    return seg.tick + static_cast<uint64_t>(static_cast<int64_t>(qd * denominator) + floorPart);
+}
+
+TempoMap::BarBeat TempoMap::toBarBeat(uint64_t tick) const noexcept {
+    auto it = std::upper_bound(meters.begin(), meters.end(), tick,
+                               [](uint64_t t, const Meter& m) { return t < m.tick; });
+    const Meter& meter = *(it - 1);
+    const uint64_t barTicks = static_cast<uint64_t>(meter.ticksPerBeat) * meter.beatsPerBar;
+    const uint64_t offset = tick - meter.tick;
+    const uint64_t inBar = offset % barTicks;
+    return { static_cast<uint32_t>(meter.bar + offset / barTicks + 1),
+             static_cast<uint32_t>(inBar / meter.ticksPerBeat + 1),
+             static_cast<uint32_t>(inBar % meter.ticksPerBeat) };
+}
+
+std::chrono::nanoseconds TempoMap::Cursor::toTime(uint64_t tick) noexcept {
+    const auto& segs = map->segments;
+    if (tick < segs[segment].tick)
+        segment = map->segmentFor(tick);
+    while (segment + 1 < segs.size() && segs[segment + 1].tick <= tick)
+        ++segment;
+    return map->timeIn(segs[segment], tick);
+}
@@ -0,0 +1,66 @@
+#pragma once
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <chrono>
+#include <cstdint>
+#include <vector>
+#include "midi_structures.h"
+
+// Tick <-> time conversion for one MIDI file. Every tempo segment stores the exact
+// time it starts at (whole nanoseconds plus a remainder in 1/division ns), so a
+// lookup is a binary search and one multiply, and long songs don't drift the way
+// a truncated ns-per-tick does.
+class TempoMap {
+public:
+    struct BarBeat {
+        uint32_t bar;      // 1-based
+        uint32_t beat;     // 1-based, in units of the time signature denominator
+        uint32_t tick;     // ticks into the beat
+    };
+
+    TempoMap() = default;
+    explicit TempoMap(const MidiFile& mid);
+
+    // Time of `tick`, rounded down to the nanosecond.
+    [[nodiscard]] std::chrono::nanoseconds toTime(uint64_t tick) const noexcept;
+    // Last tick that starts at or before `time`.
+    [[nodiscard]] uint64_t toTick(std::chrono::nanoseconds time) const noexcept;
+    // Mid-bar time signature changes start a new bar, as sequencers display them.
+    [[nodiscard]] BarBeat toBarBeat(uint64_t tick) const noexcept;
+
+    [[nodiscard]] size_t segmentCount() const noexcept { return segments.size(); }
+
+    // Amortized O(1) conversion for non-decreasing ticks, such as a track merge.
+    class Cursor {
+    public:
+        explicit Cursor(const TempoMap& tempoMap) noexcept : map(&tempoMap) {}
+        [[nodiscard]] std::chrono::nanoseconds toTime(uint64_t tick) noexcept;
+
+    private:
+        const TempoMap* map;
+        size_t segment = 0;
+    };
+
+private:
+    struct Segment {
+        uint64_t tick;
+        uint64_t perTick;   // nanoseconds per tick, times `denominator`
+        uint64_t ns;        // start time, whole nanoseconds
+        uint64_t rem;       // start time remainder, in 1/denominator ns
+    };
+    struct Meter {
+        uint64_t tick;
+        uint64_t bar;            // bars before this one
+        uint32_t ticksPerBeat;
+        uint32_t beatsPerBar;
+    };
+
+    [[nodiscard]] std::chrono::nanoseconds timeIn(const Segment& seg, uint64_t tick) const noexcept;
+    [[nodiscard]] size_t segmentFor(uint64_t tick) const noexcept;
+
+    // PPQ: perTick = tempo * 1000 over division. SMPTE: 1e9 over frames * ticks per frame.
+    uint64_t denominator = 1;
+    std::vector<Segment> segments{ { 0, 500000ULL * 1000ULL, 0, 0 } };
+    std::vector<Meter> meters{ { 0, 0, 1, 4 } };
+};
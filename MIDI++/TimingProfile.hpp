@@ -0,0 +1,46 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <string_view>
+
+// How play_notes waits for the next event. It sleeps on the high-resolution
+// waitable timer until a guard band before the deadline, then spins on the TSC
+// for the rest. A wider guard band absorbs more timer wake-up jitter and costs
+// more CPU spinning.
+namespace timing {
+
+    enum class Profile {
+        Eco,        // timer only: about a millisecond of jitter, no spinning
+        Balanced,   // spin the last millisecond
+        Ultra       // spin the last three milliseconds, enough for a late wake-up under load
+    };
+
+    // "ECO", "BALANCED" or "ULTRA"; false for anything else.
+    [[nodiscard]] inline bool profileFromName(std::string_view name, Profile& profile) noexcept {
+        if (name == "ECO")
+            profile = Profile::Eco;
+        else if (name == "BALANCED")
+            profile = Profile::Balanced;
+        else if (name == "ULTRA")
+            profile = Profile::Ultra;
+        else
+            return false;
+        return true;
+    }
+
+    [[nodiscard]] constexpr const char* profileName(Profile profile) noexcept {
+        switch (profile) {
+        case Profile::Eco:   return "ECO";
+        case Profile::Ultra: return "ULTRA";
+        default:             return "BALANCED";
+        }
+    }
+
+    [[nodiscard]] constexpr std::chrono::microseconds guardBand(Profile profile) noexcept {
+        switch (profile) {
+        case Profile::Eco:   return std::chrono::microseconds(0);
+        case Profile::Ultra: return std::chrono::microseconds(3000);
+        default:             return std::chrono::microseconds(1000);
+        }
+    }
+}
@@ -0,0 +1,160 @@
+#include "TrackFeatures.hpp"
+#include "thread_pool.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <exception>
+#include <future>
+#include <string_view>
+#include <thread>
+
+namespace {
+    // Below this many events in the whole file, thread handoff costs more than the scan.
+    constexpr size_t PARALLEL_MIN_EVENTS = 1 << 16;
+
+    dp::thread_pool<>& featurePool() {
+        static dp::thread_pool<> pool(std::max(1u, std::thread::hardware_concurrency()));
+        return pool;
+    }
+
+    bool hasDrumKeyword(PayloadView name) {
+        // "drum" also covers drums, drum kit, drumkit, ezdrummer, addictive drums, superior drummer.
+        static constexpr std::string_view keywords[] = { "drum", "bfd", "percussion" };
+        for (auto keyword : keywords) {
+            const auto hit = std::search(name.begin(), name.end(), keyword.begin(), keyword.end(),
+                [](uint8_t c, char k) { return std::tolower(c) == k; });
+            if (hit != name.end())
+                return true;
+        }
+        return false;
+    }
+}
+
+void readTrackNames(const MidiTrack& track, TrackFeatures& features) noexcept {
+    features.name = track.name.empty()
+        ? track.events.firstMeta(0x03)
+        : PayloadView(reinterpret_cast<const uint8_t*>(track.name.data()),
+                      static_cast<uint32_t>(track.name.size()));
+    features.listedName = track.events.lastMeta(0x03);
+}
+
+TrackFeatures analyzeTrack(const MidiTrack& track) {
+    TrackFeatures f;
+    const auto& events = track.events;
+    readTrackNames(track, f);
+    uint32_t firstTick = UINT32_MAX;
+    for (size_t i = 0; i < events.size(); ++i) {
+        const uint8_t status = events.status(i);
+        const uint8_t kind = status & 0xF0;
+        if (kind == 0x90 || kind == 0x80) {
+            const uint8_t pitch = events.data1(i) & 0x7F;
+            const uint32_t tick = events.tick(i);
+            ++f.noteMessages;
+            ++f.pitchHistogram[pitch];
+            f.pitchSum += pitch;
+            f.channelMask |= static_cast<uint16_t>(1u << (status & 0x0F));
+            f.lowestPitch = std::min(f.lowestPitch, pitch);
+            f.highestPitch = std::max(f.highestPitch, pitch);
+            firstTick = std::min(firstTick, tick);
+            f.lastNoteTick = std::max(f.lastNoteTick, tick);
+            if (kind == 0x80) {
+                ++f.noteOffs;
+            }
+            else if (const uint8_t velocity = events.data2(i); velocity > 0) {
+                ++f.noteOns;
+                ++f.channelNoteOns[status & 0x0F];
+                f.velocitySum += velocity;
+                f.velocitySquares += static_cast<uint64_t>(velocity) * velocity;
+            }
+        }
+        else if (kind == 0xC0) {
+            f.program = events.data1(i) & 0x7F;
+        }
+    }
+    if (f.noteMessages > 0)
+        f.firstNoteTick = firstTick;
+    return f;
+}
+
+std::vector<TrackFeatures> analyzeTracks(const MidiFile& mid) {
+    std::vector<TrackFeatures> features(mid.tracks.size());
+    size_t totalEvents = 0;
+    for (const auto& track : mid.tracks)
+        totalEvents += track.events.size();
+
+    if (mid.tracks.size() < 2 || totalEvents < PARALLEL_MIN_EVENTS) {
+        for (size_t i = 0; i < mid.tracks.size(); ++i)
+            features[i] = analyzeTrack(mid.tracks[i]);
+        return features;
+    }
+    auto& pool = featurePool();
+    std::vector<std::future<void>> pending;
+    pending.reserve(mid.tracks.size());
+    for (size_t i = 0; i < mid.tracks.size(); ++i) {
+        pending.push_back(pool.enqueue([&mid, &features, i]() {
+            features[i] = analyzeTrack(mid.tracks[i]);
+        }));
+    }
+    // Tasks reference `features`; wait for all of them before rethrowing.
+    std::exception_ptr firstError;
+    for (auto& task : pending) {
+        try {
+            task.get();
+        }
+        catch (...) {
+            if (!firstError)
+                firstError = std::current_exception();
+        }
+    }
+    if (firstError)
+        std::rethrow_exception(firstError);
+    return features;
+}
+
+double TrackFeatures::drumConfidence() const {
+    double confidence = (!name.empty() && hasDrumKeyword(name)) ? 1.0 : 0.0;
+    if (noteMessages == 0)
+        return confidence;
+    const double total = noteMessages;
+
+    const double noteOffRatio = noteOffs / total;
+    confidence += (noteOffRatio < 0.1 ? 0.1
+                  : (noteOffRatio > 0.3 ? -0.1 : 0.0));
+    const int range = highestPitch - lowestPitch;
+    confidence += (range < 20 ? 0.3 : (range < 30 ? 0.2 : 0.0));
+
+    const uint32_t maxCount = *std::max_element(pitchHistogram.begin(), pitchHistogram.end());
+    const double dominantRatio = maxCount / total;
+    confidence += (dominantRatio > 0.7 ? 0.2
+                  : (dominantRatio > 0.5 ? 0.1 : 0.0));
+    const double avgPitch = pitchSum / total;
+    if (avgPitch >= 35 && avgPitch <= 81)
+        confidence += 0.1;
+    if (channelMask == (1u << 9))
+        confidence += 0.5;
+    if (lastNoteTick > firstNoteTick) {
+        const double density = total / (lastNoteTick - firstNoteTick + 1);
+        if (density > 0.03) confidence += 0.05;
+        if (density > 0.05) confidence += 0.05;
+        if (density > 0.1)  confidence += 0.05;
+    }
+    if (noteOns > 0) {
+        const double meanVel = static_cast<double>(velocitySum) / noteOns;
+        const double variance = static_cast<double>(velocitySquares) / noteOns - meanVel * meanVel;
+        if (std::sqrt(std::max(variance, 0.0)) < 10)
+            confidence += 0.05;
+    }
+    return confidence;
+}
+
+int TrackFeatures::dominantChannel() const noexcept {
+    int best = -1;
+    uint32_t bestCount = 0;
+    for (int ch = 0; ch < 16; ++ch) {
+        if (channelNoteOns[ch] > bestCount) {
+            bestCount = channelNoteOns[ch];
+            best = ch;
+        }
+    }
+    return best;
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "midi_structures.h"
+
+// What one pass over a track's event columns tells us. Drum detection, the track
+// list and the details panel read these instead of rescanning the events.
+struct TrackFeatures {
+    // Views into the song's payload arena, valid while its MidiFile is loaded.
+    PayloadView name;                              // first non-empty track name, for drum keywords
+    PayloadView listedName;                        // last track name event, as the track list shows it
+    uint32_t noteMessages = 0;                     // every 8n/9n message, velocity 0 included
+    uint32_t noteOffs = 0;                         // 8n messages only
+    uint32_t noteOns = 0;                          // 9n with velocity > 0
+    std::array<uint32_t, 128> pitchHistogram{};    // over all note messages
+    std::array<uint32_t, 16> channelNoteOns{};
+    uint16_t channelMask = 0;                      // channels with any note message
+    uint8_t lowestPitch = 127;
+    uint8_t highestPitch = 0;
+    uint64_t pitchSum = 0;
+    uint32_t firstNoteTick = 0;
+    uint32_t lastNoteTick = 0;
+    uint64_t velocitySum = 0;                      // note-ons only
+    uint64_t velocitySquares = 0;
+    int program = -1;                              // last program change, -1 if none
+
+    // Heuristic score; 1.0 or more is almost certainly a drum track.
+    [[nodiscard]] double drumConfidence() const;
+    // Channel with the most note-ons, lowest on a tie; -1 without notes.
+    [[nodiscard]] int dominantChannel() const noexcept;
+    // Only for display; the views themselves are what detection reads.
+    [[nodiscard]] static std::string text(PayloadView view) {
+        return std::string(view.begin(), view.end());
+    }
+};
+
+[[nodiscard]] TrackFeatures analyzeTrack(const MidiTrack& track);
+// Only the name views, from the payload table; for features restored from the schedule cache.
+void readTrackNames(const MidiTrack& track, TrackFeatures& features) noexcept;
+// One entry per track; big files are analyzed on several threads.
+[[nodiscard]] std::vector<TrackFeatures> analyzeTracks(const MidiFile& mid);
@@ -1,144 +1,172 @@
-#pragma once
-
-#include <string>
-#include <map>
-#include <stdexcept>
-#include <filesystem>
-#include <optional>
-#include "json.hpp"
-
-namespace midi {
-
-    // Forward declarations
-    class ConfigException : public std::runtime_error {
-    public:
-        explicit ConfigException(const std::string& message) : std::runtime_error(message) {}
-    };
-
-    enum class VelocityCurveType {
-        LinearCoarse = 0,
-        LinearFine = 1,
-        ImprovedLowVolume = 2,
-        Logarithmic = 3,
-        Exponential = 4,
-        Custom = 5
-    };
-
-    enum class NoteHandlingMode {
-        FIFO,
-        LIFO,
-        NoHandling
-    };
-
-    // Configuration structures
-    struct VolumeSettings {
-        int MIN_VOLUME = 10;
-        int MAX_VOLUME = 200;
-        int INITIAL_VOLUME = 100;
-        int VOLUME_STEP = 10;
-        int ADJUSTMENT_INTERVAL_MS = 50;
-
-        void validate() const;
-    };
-    struct AutoTranspose {
-        bool ENABLED = false;
-        std::string TRANSPOSE_UP_KEY = "VK_UP";   // Default to Up Arrow
-        std::string TRANSPOSE_DOWN_KEY = "VK_DOWN"; // Default to Down Arrow
-
-        void validate() const;
-    };
-
-    struct AutoplayerTimingAccuracy {
-        int MAX_PASSES = 20;
-        double MEASURE_SEC = 1.0;
-
-        void validate() const;
-    };
-
-    struct UISettings {
-        bool alwaysOnTop = false;
-    };
-
-    struct MIDISettings {
-        bool DETECT_DRUMS = true;
-
-        void validate() const;
-    };
-
-    struct HotkeySettings {
-        std::string SUSTAIN_KEY = "VK_SPACE";
-        std::string VOLUME_UP_KEY = "VK_RIGHT";
-        std::string VOLUME_DOWN_KEY = "VK_LEFT";
-        std::string PLAY_PAUSE_KEY = "VK_F1";      // Added default for play/pause
-        std::string REWIND_KEY = "VK_F2";          // Added default for rewind
-        std::string SKIP_KEY = "VK_F3";            // Added default for skip
-        std::string EMERGENCY_EXIT_KEY = "VK_F4"; // Added default for emergency exit
-        void validate() const;
-    };
-
-    struct CustomVelocityCurve {
-        std::string name;
-        std::array<int, 32> velocityValues;
-    };
-
-    // Modify PlaybackSettings
-    struct PlaybackSettings {
-        VelocityCurveType velocityCurve = VelocityCurveType::LinearCoarse;
-        NoteHandlingMode noteHandlingMode = NoteHandlingMode::LIFO;
-        std::vector<CustomVelocityCurve> customVelocityCurves;
-        void validate() const;
-    };
-
-    class Config {
-    public:
-        MIDISettings midi;
-        PlaybackSettings playback;
-        VolumeSettings volume;
-        AutoTranspose auto_transpose;
-        HotkeySettings hotkeys;
-        UISettings ui;
-        AutoplayerTimingAccuracy autoplayer_timing;
-        std::map<std::string, std::map<std::string, std::string>> key_mappings;
-        std::map<std::string, std::string> controls;
-        std::vector<std::string> playlistFiles;
-
-        static Config& getInstance();
-
-        void loadFromFile(const std::filesystem::path& path);
-        void saveToFile(const std::filesystem::path& path) const;
-        void validate() const;
-        void setDefaults();
-
-        // Conversion methods made public and static
-        static NoteHandlingMode stringToNoteHandlingMode(const std::string& mode);
-        static std::string noteHandlingModeToString(NoteHandlingMode mode);
-
-        // Delete copy constructor and assignment operator
-        Config(const Config&) = delete;
-        Config& operator=(const Config&) = delete;
-
-    private:
-        Config() = default;
-
-        void validateKeyMappings() const;
-    };
-
-    // JSON conversion functions declarations
-    void to_json(nlohmann::json& j, const VolumeSettings& v);
-    void from_json(const nlohmann::json& j, VolumeSettings& v);
-    void to_json(nlohmann::json& j, const AutoTranspose& l);
-    void from_json(const nlohmann::json& j, AutoTranspose& l);
-    void to_json(nlohmann::json& j, const AutoplayerTimingAccuracy& a);
-    void from_json(const nlohmann::json& j, AutoplayerTimingAccuracy& a);
-    void to_json(nlohmann::json& j, const MIDISettings& m);
-    void from_json(const nlohmann::json& j, MIDISettings& m);
-    void to_json(nlohmann::json& j, const HotkeySettings& h);
-    void from_json(const nlohmann::json& j, HotkeySettings& h);
-    void to_json(nlohmann::json& j, const PlaybackSettings& p);
-    void from_json(const nlohmann::json& j, PlaybackSettings& p);
-    void to_json(nlohmann::json& j, const Config& c);
-    void from_json(const nlohmann::json& j, Config& c);
-    void to_json(nlohmann::json& j, const UISettings& ui);
-    void from_json(const nlohmann::json& j, UISettings& ui);
-
+#pragma once
+
+#include <string>
+#include <map>
+#include <stdexcept>
+#include <filesystem>
+#include <optional>
+#include "json.hpp"
+
+namespace midi {
+
+    // Forward declarations
+    class ConfigException : public std::runtime_error {
+    public:
+        explicit ConfigException(const std::string& message) : std::runtime_error(message) {}
+    };
+
+    enum class VelocityCurveType {
+        LinearCoarse = 0,
+        LinearFine = 1,
+        ImprovedLowVolume = 2,
+        Logarithmic = 3,
+        Exponential = 4,
+        Custom = 5
+    };
+
+    enum class NoteHandlingMode {
+        FIFO,
+        LIFO,
+        NoHandling
+    };
+
+    // Configuration structures
+    struct VolumeSettings {
+        int MIN_VOLUME = 10;
+        int MAX_VOLUME = 200;
+        int INITIAL_VOLUME = 100;
+        int VOLUME_STEP = 10;
+        int ADJUSTMENT_INTERVAL_MS = 50;
+
+        void validate() const;
+    };
+    struct AutoTranspose {
+        bool ENABLED = false;
+        std::string TRANSPOSE_UP_KEY = "VK_UP";   // Default to Up Arrow
+        std::string TRANSPOSE_DOWN_KEY = "VK_DOWN"; // Default to Down Arrow
+
+        void validate() const;
+    };
+
+    struct AutoplayerTimingAccuracy {
+        int MAX_PASSES = 20;
+        double MEASURE_SEC = 1.0;
+        std::string DISPATCH_MODE = "INLINE"; // who injects due batches: INLINE (playback thread), INJECTOR (pinned thread) or POOL
+        int INJECTOR_CPU = -1;                // logical processor the INJECTOR thread is pinned to, -1 for the last one
+        int INPUT_BATCH_CAP = 64;             // INPUTs per SendInput call when gathering a batch's keys, 0 for a call per key
+        std::string LATENCY_PROFILE = "BALANCED"; // waiting for the next event: ECO (timer only), BALANCED or ULTRA (spin longer)
+        int SPIN_GUARD_US = -1;               // spin this long before each event instead of the profile's band, -1 to keep it
+        bool LATENESS_DUMP = false;           // also write each pause's lateness histogram to lateness.json
+        bool COMPILED_PLAYBACK = true;        // play finished schedules from pre-built INPUT batches per timestamp
+
+        void validate() const;
+    };
+
+    struct UISettings {
+        bool alwaysOnTop = false;
+    };
+
+    struct MIDISettings {
+        bool DETECT_DRUMS = true;
+        double DRUM_THRESHOLD = 0.8;  // drumConfidence (clamped to 1.0) at which a track counts as drums
+        bool MAPPED_PARSE = true; // decode tracks straight from a file mapping instead of an ifstream copy
+        bool PARALLEL_DECODE = true; // decode MTrk chunks concurrently on a worker pool
+        bool PRESCAN_EVENTS = true;  // count large tracks first so event storage is allocated once
+        bool STREAMING_LOAD = true;  // build the playback schedule in the background instead of before Load returns
+        bool LENIENT_PARSE = false;  // drop corrupt tracks instead of rejecting the whole file
+        bool VECTOR_SCAN = true;     // decode runs of channel messages with SSE2/AVX2 instead of byte by byte
+        std::string META_PROFILE = "PLAYBACK"; // meta/SysEx kept on load: PLAYBACK (what playback reads) or FULL
+        bool SCHEDULE_CACHE = true;  // keep finished schedules in .midipp_cache next to the MIDI files
+        bool SUSTAIN_COALESCE = true; // schedule only CC64 messages that cross the sustain cutoff
+        int SUSTAIN_HYSTERESIS = 0;   // with coalescing, the pedal lifts only below cutoff minus this
+        bool DEDUP_NOTES = false;     // skip presses of a key another audible copy struck within DEDUP_WINDOW_MS
+        double DEDUP_WINDOW_MS = 2.0;
+        bool THIN_NOTES = false;      // drop the least important presses where a window exceeds its key budget
+        double THIN_WINDOW_MS = 50.0;
+        int THIN_MAX_KEYS_PER_WINDOW = 40; // key events (press + release) allowed per window
+        double THIN_SHORT_NOTE_MS = 25.0;  // notes shorter than this rank lower
+        int POLYPHONY_LIMIT = 0;      // most keys held at once, 0 for no limit
+        std::string POLYPHONY_STEAL = "OLDEST"; // key released early at the limit: OLDEST, QUIETEST or LOWEST_NOT_BASS
+
+        void validate() const;
+    };
+
+    struct HotkeySettings {
+        std::string SUSTAIN_KEY = "VK_SPACE";
+        std::string VOLUME_UP_KEY = "VK_RIGHT";
+        std::string VOLUME_DOWN_KEY = "VK_LEFT";
+        std::string PLAY_PAUSE_KEY = "VK_F1";      // Added default for play/pause
+        std::string REWIND_KEY = "VK_F2";          // Added default for rewind
+        std::string SKIP_KEY = "VK_F3";            // Added default for skip
+        std::string EMERGENCY_EXIT_KEY = "VK_F4"; // Added default for emergency exit
+        std::string NOTE_MODE_KEY = "VK_F5";      // cycles the stacked note handling mode
+        std::string DRUM_DETECT_KEY = "VK_F6";    // toggles MIDI_SETTINGS.DETECT_DRUMS
+        void validate() const;
+    };
+
+    struct CustomVelocityCurve {
+        std::string name;
+        std::array<int, 32> velocityValues;
+    };
+
+    // Modify PlaybackSettings
+    struct PlaybackSettings {
+        VelocityCurveType velocityCurve = VelocityCurveType::LinearCoarse;
+        NoteHandlingMode noteHandlingMode = NoteHandlingMode::LIFO;
+        std::vector<CustomVelocityCurve> customVelocityCurves;
+        void validate() const;
+    };
+
+    class Config {
+    public:
+        MIDISettings midi;
+        PlaybackSettings playback;
+        VolumeSettings volume;
+        AutoTranspose auto_transpose;
+        HotkeySettings hotkeys;
+        UISettings ui;
+        AutoplayerTimingAccuracy autoplayer_timing;
+        std::map<std::string, std::map<std::string, std::string>> key_mappings;
+        std::map<std::string, std::string> controls;
+        std::vector<std::string> playlistFiles;
+
+        static Config& getInstance();
+
+        void loadFromFile(const std::filesystem::path& path);
+        void saveToFile(const std::filesystem::path& path) const;
+        void validate() const;
+        void setDefaults();
+
+        // Conversion methods made public and static
+        static NoteHandlingMode stringToNoteHandlingMode(const std::string& mode);
+        static std::string noteHandlingModeToString(NoteHandlingMode mode);
+
+        // Delete copy constructor and assignment operator
+        Config(const Config&) = delete;
+        Config& operator=(const Config&) = delete;
+
+    private:
+        Config() = default;
+
+        void validateKeyMappings() const;
+    };
+
+    // JSON conversion functions declarations
+    void to_json(nlohmann::json& j, const VolumeSettings& v);
+    void from_json(const nlohmann::json& j, VolumeSettings& v);
+    void to_json(nlohmann::json& j, const AutoTranspose& l);
+    void from_json(const nlohmann::json& j, AutoTranspose& l);
+    void to_json(nlohmann::json& j, const AutoplayerTimingAccuracy& a);
+    void from_json(const nlohmann::json& j, AutoplayerTimingAccuracy& a);
+    void to_json(nlohmann::json& j, const MIDISettings& m);
+    void from_json(const nlohmann::json& j, MIDISettings& m);
+    void to_json(nlohmann::json& j, const HotkeySettings& h);
+    void from_json(const nlohmann::json& j, HotkeySettings& h);
+    void to_json(nlohmann::json& j, const PlaybackSettings& p);
+    void from_json(const nlohmann::json& j, PlaybackSettings& p);
+    void to_json(nlohmann::json& j, const Config& c);
+    void from_json(const nlohmann::json& j, Config& c);
+    void to_json(nlohmann::json& j, const UISettings& ui);
+    void from_json(const nlohmann::json& j, UISettings& ui);
+
 } // namespace midi
\ No newline at end of file
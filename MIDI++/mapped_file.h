@@ -0,0 +1,111 @@
+#pragma once
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Read-only view of a whole file (MapViewOfFile on Windows, mmap elsewhere).
+// The view stays valid until close() or destruction; nothing is copied.
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    [[nodiscard]] bool open(const std::filesystem::path& path) {
+        close();
+#ifdef _WIN32
+        fileHandle = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (fileHandle == INVALID_HANDLE_VALUE) {
+            fileHandle = nullptr;
+            return false;
+        }
+        LARGE_INTEGER fileSize{};
+        if (!GetFileSizeEx(fileHandle, &fileSize)) {
+            close();
+            return false;
+        }
+        viewSize = static_cast<size_t>(fileSize.QuadPart);
+        if (viewSize == 0)
+            return true; // Nothing to map; callers see an empty view.
+        mappingHandle = CreateFileMappingW(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mappingHandle) {
+            close();
+            return false;
+        }
+        view = static_cast<const char*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+        if (!view) {
+            close();
+            return false;
+        }
+#else
+        fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            return false;
+        struct stat st {};
+        if (::fstat(fd, &st) != 0) {
+            close();
+            return false;
+        }
+        viewSize = static_cast<size_t>(st.st_size);
+        if (viewSize == 0)
+            return true;
+        void* mapped = ::mmap(nullptr, viewSize, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped == MAP_FAILED) {
+            close();
+            return false;
+        }
+        ::madvise(mapped, viewSize, MADV_SEQUENTIAL);
+        view = static_cast<const char*>(mapped);
+#endif
+        return true;
+    }
+
+    void close() noexcept {
+#ifdef _WIN32
+        if (view)
+            UnmapViewOfFile(view);
+        if (mappingHandle)
+            CloseHandle(mappingHandle);
+        if (fileHandle)
+            CloseHandle(fileHandle);
+        mappingHandle = nullptr;
+        fileHandle = nullptr;
+#else
+        if (view)
+            ::munmap(const_cast<char*>(view), viewSize);
+        if (fd >= 0)
+            ::close(fd);
+        fd = -1;
+#endif
+        view = nullptr;
+        viewSize = 0;
+    }
+
+    [[nodiscard]] const char* data() const noexcept { return view; }
+    [[nodiscard]] size_t size() const noexcept { return viewSize; }
+
+private:
+#ifdef _WIN32
+    HANDLE fileHandle = nullptr;
+    HANDLE mappingHandle = nullptr;
+#else
+    int fd = -1;
+#endif
+    const char* view = nullptr;
+    size_t viewSize = 0;
+};
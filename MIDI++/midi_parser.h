@@ -1,23 +1,172 @@
-#pragma once
-#define NOMINMAX
-#include "midi_structures.h"
-#include <fstream>
-#include <string>
-#include <cstdint>
-#include <windows.h>
-
-class MidiParser {
-public:
-    void reset();
-    [[nodiscard]] MidiFile parse(const std::string& filename);
-private:
-    mutable std::ifstream file;
-    static constexpr uint32_t swapUint32(uint32_t value) noexcept;
-    static constexpr uint16_t swapUint16(uint16_t value) noexcept;
-    [[nodiscard]] bool readInt32(uint32_t& value);
-    [[nodiscard]] bool readInt16(uint16_t& value);  // For unsigned fields
-    [[nodiscard]] bool readInt16(int16_t& value);   // For signed division
-    [[nodiscard]] bool readChunk(char* buffer, size_t size);
-    void parseMetaEvent(MidiEvent& event, MidiFile& midiFile, uint32_t absoluteTick,
-        const char* trackEnd, const char*& ptr);
-};
\ No newline at end of file
+#pragma once
+#define NOMINMAX
+#include "midi_structures.h"
+#include <fstream>
+#include <string>
+#include <cstdint>
+#include <vector>
+#include <bitset>
+#include <filesystem>
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+class MappedFile;
+
+// Where parse() pulls the file bytes from.
+enum class ParseMode {
+    Stream,  // std::ifstream, every MTrk chunk copied into its own buffer
+    Mapped   // read-only file mapping, tracks decoded in place from the view
+};
+
+// Why a track failed to decode. The decoder returns these instead of throwing;
+// parse() turns them into exceptions unless lenient decoding is on.
+enum class DecodeError : uint8_t {
+    None,
+    UnexpectedEnd,
+    VarLenTooLong,
+    TickOverflow,
+    RunningStatusWithoutStatus,
+    ChannelEventTruncated,
+    SysExTooLong,
+    SysExTruncated,
+    MetaTooLong,
+    MetaTruncated,
+    BadTimeSignature
+};
+
+struct DecodeStatus {
+    DecodeError error = DecodeError::None;
+    uint32_t offset = 0;     // byte offset into the MTrk payload where decoding stopped
+
+    explicit operator bool() const noexcept { return error == DecodeError::None; }
+};
+
+[[nodiscard]] const char* describeDecodeError(DecodeError error) noexcept;
+
+// A track that lenient decoding dropped, and why.
+struct SkippedTrack {
+    int track;
+    std::string reason;
+};
+
+// Which meta (FF) and SysEx events parse() keeps in the track event stores. Anything
+// else is stepped over without copying its payload. Tempo, time signature and key
+// signature changes reach MidiFile's lists whichever profile is used.
+class MetaRetention {
+public:
+    // Track names (03), end of track (2F), tempo (51), time (58) and key signature (59):
+    // everything playback and the track list read back.
+    [[nodiscard]] static MetaRetention playback();
+    // Every meta and SysEx event, for tools that need the whole file.
+    [[nodiscard]] static MetaRetention full();
+
+    MetaRetention& keep(uint8_t metaType) { metaTypes.set(metaType); return *this; }
+    MetaRetention& keepSysEx(bool enabled = true) noexcept { sysEx = enabled; return *this; }
+    [[nodiscard]] bool keepsMeta(uint8_t metaType) const noexcept { return metaTypes.test(metaType); }
+    [[nodiscard]] bool keepsSysEx() const noexcept { return sysEx; }
+private:
+    std::bitset<256> metaTypes;
+    bool sysEx = false;
+};
+
+// Throughput of the last parse() call, so both modes can be compared.
+struct ParseStats {
+    ParseMode mode = ParseMode::Stream;
+    uint64_t bytes = 0;
+    double seconds = 0.0;
+    unsigned threads = 1;    // workers that decoded tracks (1 = inline)
+    uint64_t events = 0;
+    uint64_t eventBytes = 0; // event columns + payload arena held by the result
+    // Growth the counting pre-pass made unnecessary (0 when it is off).
+    uint64_t reallocationsAvoided = 0;
+    uint64_t bytesCopyAvoided = 0;
+    uint64_t payloadBytesDropped = 0;          // meta/SysEx bytes the retention profile skipped
+    std::vector<SkippedTrack> skippedTracks;   // lenient mode only
+
+    [[nodiscard]] double bytesPerSecond() const noexcept {
+        return seconds > 0.0 ? static_cast<double>(bytes) / seconds : 0.0;
+    }
+};
+
+class MidiParser {
+public:
+    void reset();
+    void setMode(ParseMode newMode) noexcept { mode = newMode; }
+    [[nodiscard]] ParseMode getMode() const noexcept { return mode; }
+    void setParallelDecode(bool enabled) noexcept { parallelDecode = enabled; }
+    void setPrescan(bool enabled) noexcept { options.prescan = enabled; }
+    // Bulk-decode runs of channel messages with SSE2/AVX2 masks (output is identical either way).
+    void setVectorScan(bool enabled) noexcept { options.vectorScan = enabled; }
+    // Defaults to MetaRetention::playback().
+    void setMetaRetention(const MetaRetention& retention) { options.retention = retention; }
+    // Corrupt tracks are emptied and listed in ParseStats::skippedTracks instead of failing the load.
+    void setLenient(bool enabled) noexcept { lenientDecode = enabled; }
+    [[nodiscard]] const ParseStats& getLastStats() const noexcept { return lastStats; }
+    [[nodiscard]] MidiFile parse(const std::string& filename);
+
+    // Which decoder decodeTrackPayload runs, so tests can hold the vector scans to the scalar one.
+    enum class ScanPath {
+        Scalar,   // decodeTrack's byte-by-byte loop only
+        Narrow,   // 16-byte SSE2 masks (8-byte words off x86)
+        Wide      // 32-byte AVX2 masks; needs wideScanAvailable()
+    };
+    [[nodiscard]] static bool wideScanAvailable() noexcept;
+    // Decodes one MTrk payload on its own, keeping every meta and SysEx event.
+    [[nodiscard]] static DecodeStatus decodeTrackPayload(const char* data, size_t length, ScanPath path,
+        MidiTrack& track);
+private:
+    // One MTrk payload located by the header walk; points into the mapped view
+    // or into a buffer owned by parse() for the duration of the decode.
+    struct TrackChunk {
+        const char* data;
+        uint32_t length;
+    };
+    // Stored events and payload volume of one track, from the counting pre-pass.
+    struct TrackCounts {
+        size_t events = 0;
+        size_t payloadEvents = 0;
+        size_t payloadBytes = 0;
+    };
+    // Everything a single track contributes, so tracks can decode independently.
+    struct DecodedTrack {
+        MidiTrack track;
+        std::vector<TempoChange> tempoChanges;
+        std::vector<TimeSignature> timeSignatures;
+        std::vector<KeySignature> keySignatures;
+        std::vector<uint8_t> payloads;   // meta/SysEx bytes, merged into MidiFile::payloadArena
+        uint64_t droppedBytes = 0;       // payload bytes the retention profile skipped
+        TrackCounts counts;              // filled by the pre-pass only
+    };
+    // Switches every track decode reads; tasks on the pool share one instance.
+    struct DecodeOptions {
+        bool prescan = true;
+        bool vectorScan = true;
+        bool wideScan = true;    // use AVX2 where the CPU has it
+        MetaRetention retention = MetaRetention::playback();
+    };
+
+    mutable std::ifstream file;
+    ParseMode mode = ParseMode::Stream;
+    bool parallelDecode = true;
+    DecodeOptions options;
+    bool lenientDecode = false;
+    ParseStats lastStats;
+    static constexpr uint32_t swapUint32(uint32_t value) noexcept;
+    static constexpr uint16_t swapUint16(uint16_t value) noexcept;
+    [[nodiscard]] bool readInt32(uint32_t& value);
+    [[nodiscard]] bool readInt16(uint16_t& value);  // For unsigned fields
+    [[nodiscard]] bool readInt16(int16_t& value);   // For signed division
+    [[nodiscard]] bool readChunk(char* buffer, size_t size);
+    [[nodiscard]] uint64_t walkStream(const std::filesystem::path& path, const std::string& filename, MidiFile& midiFile,
+        std::vector<std::vector<char>>& buffers, std::vector<TrackChunk>& chunks);
+    [[nodiscard]] static uint64_t walkMapped(const MappedFile& mapped, MidiFile& midiFile, std::vector<TrackChunk>& chunks);
+    static void validateHeader(const MidiFile& midiFile);
+    void decodeChunks(const std::vector<TrackChunk>& chunks, MidiFile& midiFile, ParseStats& stats) const;
+    [[nodiscard]] static TrackCounts countTrack(const char* ptr, const char* trackEnd,
+        const MetaRetention& retention) noexcept;
+    [[nodiscard]] static DecodeStatus decodeTrack(const char* trackBegin, const char* trackLimit,
+        DecodedTrack& decoded, const DecodeOptions& options);
+    [[nodiscard]] static DecodeError parseMetaEvent(DecodedTrack& decoded, uint32_t absoluteTick,
+        const uint8_t* trackEnd, const uint8_t*& ptr, const MetaRetention& retention);
+};
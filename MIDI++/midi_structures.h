@@ -1,56 +1,226 @@
-#pragma once
-#include <vector>
-#include <string>
-#include <cstdint>
-
-struct MidiEvent {
-    uint32_t absoluteTick = 0;
-    uint8_t status = 0;
-    uint8_t data1 = 0;
-    uint8_t data2 = 0;
-    std::vector<uint8_t> metaData;
-    int trackIndex = 0;  // Initialized to zero
-
-    [[nodiscard]] constexpr uint32_t getAbsoluteTick() const noexcept { return absoluteTick; }
-    [[nodiscard]] constexpr uint8_t getStatus() const noexcept { return status; }
-    [[nodiscard]] constexpr uint8_t getData1() const noexcept { return data1; }
-    [[nodiscard]] constexpr uint8_t getData2() const noexcept { return data2; }
-    [[nodiscard]] const std::vector<uint8_t>& getMetaData() const noexcept { return metaData; }
-
-    void setMetaData(std::vector<uint8_t>&& md) noexcept { metaData = std::move(md); }
-};
-
-struct TempoChange {
-    uint32_t tick;
-    uint32_t microsecondsPerQuarter;
-};
-
-struct TimeSignature {
-    uint32_t tick;
-    uint8_t numerator;
-    uint8_t denominator;
-    uint8_t clocksPerClick;
-    uint8_t thirtySecondNotesPerQuarter;
-};
-
-struct KeySignature {
-    uint32_t tick;
-    int8_t key;
-    uint8_t scale;
-};
-
-struct MidiTrack {
-    std::string name;
-    std::vector<MidiEvent> events;
-};
-
-struct MidiFile {
-    uint16_t format = 0;
-    uint16_t numTracks = 0;
-    uint16_t division = 0; // For PPQ: ticks per quarter note.
-    // For SMPTE: MSB set; low byte = ticks per frame, high byte (as signed) = -frames per second
-    std::vector<MidiTrack> tracks;
-    std::vector<TempoChange> tempoChanges;
-    std::vector<TimeSignature> timeSignatures;
-    std::vector<KeySignature> keySignatures;
-};
+#pragma once
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <algorithm>
+
+// Read-only window onto a meta/SysEx payload held in the file's shared byte arena.
+// Valid for as long as the owning MidiFile (or any copy of its tracks) is alive.
+class PayloadView {
+public:
+    constexpr PayloadView() noexcept = default;
+    constexpr PayloadView(const uint8_t* bytes, uint32_t length) noexcept : ptr(bytes), len(length) {}
+
+    [[nodiscard]] constexpr const uint8_t* data() const noexcept { return ptr; }
+    [[nodiscard]] constexpr const uint8_t* begin() const noexcept { return ptr; }
+    [[nodiscard]] constexpr const uint8_t* end() const noexcept { return ptr + len; }
+    [[nodiscard]] constexpr size_t size() const noexcept { return len; }
+    [[nodiscard]] constexpr bool empty() const noexcept { return len == 0; }
+    [[nodiscard]] constexpr uint8_t operator[](size_t i) const noexcept { return ptr[i]; }
+
+private:
+    const uint8_t* ptr = nullptr;
+    uint32_t len = 0;
+};
+
+// One event as seen through MidiEventStore. Cheap to copy; owns nothing.
+struct MidiEvent {
+    uint32_t absoluteTick = 0;
+    uint8_t status = 0;
+    uint8_t data1 = 0;
+    uint8_t data2 = 0;
+    PayloadView metaData;
+    int trackIndex = 0;  // Initialized to zero
+
+    [[nodiscard]] constexpr uint32_t getAbsoluteTick() const noexcept { return absoluteTick; }
+    [[nodiscard]] constexpr uint8_t getStatus() const noexcept { return status; }
+    [[nodiscard]] constexpr uint8_t getData1() const noexcept { return data1; }
+    [[nodiscard]] constexpr uint8_t getData2() const noexcept { return data2; }
+    [[nodiscard]] constexpr PayloadView getMetaData() const noexcept { return metaData; }
+};
+
+// Column storage for a track's events: 7 bytes per event plus a sparse table for
+// the few events that carry a payload. Iteration yields MidiEvent views, so
+// `for (const auto& evt : track.events)` keeps working unchanged.
+class MidiEventStore {
+    struct PayloadRef {
+        uint32_t eventIndex;
+        uint32_t length;
+        size_t offset;   // into the arena (track-local until attachArena rebases it)
+    };
+
+public:
+    class const_iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = MidiEvent;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = MidiEvent;
+
+        const_iterator() noexcept = default;
+        const_iterator(const MidiEventStore* owner, size_t index, size_t payloadCursor) noexcept
+            : store(owner), pos(index), cursor(payloadCursor) {}
+
+        [[nodiscard]] MidiEvent operator*() const noexcept {
+            const bool hasPayload = cursor < store->payloads.size() && store->payloads[cursor].eventIndex == pos;
+            return store->makeEvent(pos, hasPayload ? &store->payloads[cursor] : nullptr);
+        }
+        const_iterator& operator++() noexcept {
+            if (cursor < store->payloads.size() && store->payloads[cursor].eventIndex == pos)
+                ++cursor;
+            ++pos;
+            return *this;
+        }
+        const_iterator operator++(int) noexcept { const_iterator tmp = *this; ++*this; return tmp; }
+        [[nodiscard]] bool operator==(const const_iterator& other) const noexcept { return pos == other.pos; }
+        [[nodiscard]] bool operator!=(const const_iterator& other) const noexcept { return pos != other.pos; }
+        [[nodiscard]] size_t index() const noexcept { return pos; }
+        [[nodiscard]] uint32_t tick() const noexcept { return store->ticks[pos]; }
+
+    private:
+        const MidiEventStore* store = nullptr;
+        size_t pos = 0;
+        size_t cursor = 0;
+    };
+
+    [[nodiscard]] size_t size() const noexcept { return ticks.size(); }
+    [[nodiscard]] bool empty() const noexcept { return ticks.empty(); }
+    [[nodiscard]] const_iterator begin() const noexcept { return const_iterator(this, 0, 0); }
+    [[nodiscard]] const_iterator end() const noexcept { return const_iterator(this, ticks.size(), payloads.size()); }
+
+    // Random access costs a binary search over the payload table; prefer iterating.
+    [[nodiscard]] MidiEvent operator[](size_t i) const noexcept {
+        auto it = std::lower_bound(payloads.begin(), payloads.end(), i,
+            [](const PayloadRef& ref, size_t idx) { return ref.eventIndex < idx; });
+        return makeEvent(i, (it != payloads.end() && it->eventIndex == i) ? &*it : nullptr);
+    }
+
+    // Column access for hot scans that don't need the payload.
+    [[nodiscard]] uint32_t tick(size_t i) const noexcept { return ticks[i]; }
+    [[nodiscard]] uint8_t status(size_t i) const noexcept { return statuses[i]; }
+    [[nodiscard]] uint8_t data1(size_t i) const noexcept { return data1s[i]; }
+    [[nodiscard]] uint8_t data2(size_t i) const noexcept { return data2s[i]; }
+
+    void reserve(size_t events, size_t payloadEvents = 0) {
+        ticks.reserve(events);
+        statuses.reserve(events);
+        data1s.reserve(events);
+        data2s.reserve(events);
+        payloads.reserve(payloadEvents);
+    }
+
+    void push_back(uint32_t tick, uint8_t status, uint8_t data1, uint8_t data2) {
+        ticks.push_back(tick);
+        statuses.push_back(status);
+        data1s.push_back(data1);
+        data2s.push_back(data2);
+    }
+
+    // Appends an event whose payload lives at [offset, offset + length) of the arena.
+    void pushWithPayload(uint32_t tick, uint8_t status, uint8_t data1, size_t offset, uint32_t length) {
+        payloads.push_back({ static_cast<uint32_t>(ticks.size()), length, offset });
+        push_back(tick, status, data1, 0);
+    }
+
+    // Points payload offsets at the shared per-file arena, `base` bytes in.
+    void attachArena(std::shared_ptr<const std::vector<uint8_t>> fileArena, size_t base, int index) {
+        for (auto& ref : payloads)
+            ref.offset += base;
+        arena = std::move(fileArena);
+        trackIndex = index;
+    }
+
+    [[nodiscard]] size_t payloadCount() const noexcept { return payloads.size(); }
+
+    // Payload of the first non-empty, or the last, meta event of `type` (0x03 is a
+    // track name); empty if there is none. Walks the payload table only, not the events.
+    [[nodiscard]] PayloadView firstMeta(uint8_t type) const noexcept {
+        for (const auto& ref : payloads) {
+            if (ref.length > 0 && isMeta(ref, type))
+                return payloadOf(ref);
+        }
+        return {};
+    }
+    [[nodiscard]] PayloadView lastMeta(uint8_t type) const noexcept {
+        for (auto it = payloads.rbegin(); it != payloads.rend(); ++it) {
+            if (isMeta(*it, type))
+                return payloadOf(*it);
+        }
+        return {};
+    }
+    [[nodiscard]] static constexpr size_t payloadRefSize() noexcept { return sizeof(PayloadRef); }
+    // Bytes held by the columns, excluding the shared arena.
+    [[nodiscard]] size_t residentBytes() const noexcept {
+        return ticks.capacity() * sizeof(uint32_t) + statuses.capacity() + data1s.capacity()
+            + data2s.capacity() + payloads.capacity() * sizeof(PayloadRef);
+    }
+
+private:
+    [[nodiscard]] bool isMeta(const PayloadRef& ref, uint8_t type) const noexcept {
+        return statuses[ref.eventIndex] == 0xFF && data1s[ref.eventIndex] == type;
+    }
+    [[nodiscard]] PayloadView payloadOf(const PayloadRef& ref) const noexcept {
+        return arena ? PayloadView(arena->data() + ref.offset, ref.length) : PayloadView();
+    }
+
+    [[nodiscard]] MidiEvent makeEvent(size_t i, const PayloadRef* ref) const noexcept {
+        MidiEvent evt;
+        evt.absoluteTick = ticks[i];
+        evt.status = statuses[i];
+        evt.data1 = data1s[i];
+        evt.data2 = data2s[i];
+        if (ref && arena)
+            evt.metaData = PayloadView(arena->data() + ref->offset, ref->length);
+        evt.trackIndex = trackIndex;
+        return evt;
+    }
+
+    std::vector<uint32_t> ticks;
+    std::vector<uint8_t> statuses;
+    std::vector<uint8_t> data1s;
+    std::vector<uint8_t> data2s;
+    std::vector<PayloadRef> payloads;   // sorted by eventIndex
+    std::shared_ptr<const std::vector<uint8_t>> arena;
+    int trackIndex = 0;
+};
+
+struct TempoChange {
+    uint32_t tick;
+    uint32_t microsecondsPerQuarter;
+};
+
+struct TimeSignature {
+    uint32_t tick;
+    uint8_t numerator;
+    uint8_t denominator;
+    uint8_t clocksPerClick;
+    uint8_t thirtySecondNotesPerQuarter;
+};
+
+struct KeySignature {
+    uint32_t tick;
+    int8_t key;
+    uint8_t scale;
+};
+
+struct MidiTrack {
+    std::string name;
+    MidiEventStore events;
+};
+
+struct MidiFile {
+    uint16_t format = 0;
+    uint16_t numTracks = 0;
+    uint16_t division = 0; // For PPQ: ticks per quarter note.
+    // For SMPTE: MSB set; low byte = ticks per frame, high byte (as signed) = -frames per second
+    std::vector<MidiTrack> tracks;
+    std::vector<TempoChange> tempoChanges;
+    std::vector<TimeSignature> timeSignatures;
+    std::vector<KeySignature> keySignatures;
+    // Meta/SysEx bytes for every track; MidiEventStore views point into this.
+    std::shared_ptr<const std::vector<uint8_t>> payloadArena;
+};
@@ -0,0 +1,283 @@
+#include "LibraryIndex.hpp"
+#include "midi_parser.h"
+#include "TempoMap.hpp"
+#include "thread_pool.h"
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <future>
+#include <system_error>
+#include <unordered_map>
+
+namespace fs = std::filesystem;
+
+namespace {
+    constexpr char INDEX_MAGIC[8] = { 'M', 'I', 'D', 'I', 'P', 'P', 'I', 'X' };
+    constexpr uint32_t INDEX_VERSION = 1;
+    // Paths and parser messages are short; anything longer means a corrupt index.
+    constexpr uint32_t MAX_STRING_BYTES = 64 * 1024;
+
+    std::string toUtf8(const fs::path& path) {
+        const std::u8string text = path.generic_u8string();
+        return std::string(reinterpret_cast<const char*>(text.data()), text.size());
+    }
+
+    fs::path fromUtf8(const std::string& text) {
+        return fs::path(std::u8string(reinterpret_cast<const char8_t*>(text.data()), text.size()));
+    }
+
+    bool isMidiFile(const fs::path& path) {
+        std::string ext = toUtf8(path.extension());
+        std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        return ext == ".mid" || ext == ".midi" || ext == ".kar";
+    }
+
+    class IndexWriter {
+    public:
+        explicit IndexWriter(std::ofstream& stream) : out(stream) {}
+        template <typename T>
+        void put(const T& value) { out.write(reinterpret_cast<const char*>(&value), sizeof(value)); }
+        void putString(const std::string& text) {
+            put(static_cast<uint32_t>(text.size()));
+            out.write(text.data(), static_cast<std::streamsize>(text.size()));
+        }
+    private:
+        std::ofstream& out;
+    };
+
+    class IndexReader {
+    public:
+        explicit IndexReader(std::ifstream& stream) : in(stream) {}
+        template <typename T>
+        bool get(T& value) { return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(value))); }
+        bool getString(std::string& text) {
+            uint32_t length = 0;
+            if (!get(length) || length > MAX_STRING_BYTES)
+                return false;
+            text.resize(length);
+            return static_cast<bool>(in.read(text.data(), length));
+        }
+    private:
+        std::ifstream& in;
+    };
+}
+
+IndexEntry LibraryIndex::summarize(const fs::path& file) {
+    IndexEntry entry;
+    MidiParser parser;
+    parser.setMode(ParseMode::Mapped);
+    // Files are already spread over the pool; one file per worker beats splitting tracks.
+    parser.setParallelDecode(false);
+    // Nothing here reads meta payloads; tempo and time signatures still reach their lists.
+    parser.setMetaRetention(MetaRetention{});
+    MidiFile mid;
+    try {
+        mid = parser.parse(toUtf8(file));
+    }
+    catch (const std::exception& e) {
+        entry.error = e.what();
+        return entry;
+    }
+
+    entry.ok = true;
+    entry.format = mid.format;
+    entry.division = mid.division;
+    uint8_t lowest = 127, highest = 0;
+    uint32_t lastNoteTick = 0;
+    for (const auto& track : mid.tracks) {
+        const auto& events = track.events;
+        if (!events.empty())
+            ++entry.tracks;
+        for (size_t i = 0; i < events.size(); ++i) {
+            const uint8_t kind = events.status(i) & 0xF0;
+            if (kind != 0x90 && kind != 0x80)
+                continue;
+            lastNoteTick = std::max(lastNoteTick, events.tick(i));
+            if (kind == 0x90 && events.data2(i) > 0) {
+                ++entry.notes;
+                entry.channels |= static_cast<uint16_t>(1u << (events.status(i) & 0x0F));
+                lowest = std::min(lowest, events.data1(i));
+                highest = std::max(highest, events.data1(i));
+            }
+        }
+    }
+    if (entry.notes > 0) {
+        entry.lowestNote = lowest;
+        entry.highestNote = highest;
+    }
+    entry.tempoChanges = static_cast<uint32_t>(mid.tempoChanges.size());
+    // The tempo in force at tick 0; as in TempoMap, the later of several there wins and
+    // a file whose first tempo event comes later starts at the 120 bpm default.
+    for (const auto& tc : mid.tempoChanges) {
+        if (tc.tick == 0 && tc.microsecondsPerQuarter > 0)
+            entry.initialBpm = 60000000.0 / tc.microsecondsPerQuarter;
+    }
+    if (!mid.timeSignatures.empty()) {
+        entry.timeSigNumerator = mid.timeSignatures.front().numerator;
+        entry.timeSigDenominator = mid.timeSignatures.front().denominator;
+    }
+    entry.seconds = std::chrono::duration<double>(TempoMap(mid).toTime(lastNoteTick)).count();
+    return entry;
+}
+
+IndexStats LibraryIndex::update(const fs::path& root, unsigned threads, bool rebuild) {
+    const auto start = std::chrono::steady_clock::now();
+    IndexStats stats;
+    std::error_code ec;
+    const fs::path base = fs::absolute(root, ec).lexically_normal();
+
+    std::unordered_map<std::string, const IndexEntry*> previous;
+    for (const auto& entry : items)
+        previous.emplace(entry.path, &entry);
+
+    std::vector<IndexEntry> next;
+    std::vector<size_t> pending;
+    size_t stillPresent = 0;
+    auto it = fs::recursive_directory_iterator(base, fs::directory_options::skip_permission_denied, ec);
+    for (; !ec && it != fs::recursive_directory_iterator(); it.increment(ec)) {
+        std::error_code fileError;
+        if (!it->is_regular_file(fileError) || !isMidiFile(it->path()))
+            continue;
+        IndexEntry entry;
+        entry.path = toUtf8(it->path().lexically_relative(base));
+        entry.fileSize = it->file_size(fileError);
+        entry.modified = static_cast<int64_t>(it->last_write_time(fileError).time_since_epoch().count());
+        if (fileError)
+            continue;
+
+        auto found = previous.find(entry.path);
+        if (found != previous.end()) {
+            ++stillPresent;
+            const IndexEntry& old = *found->second;
+            if (!rebuild && old.fileSize == entry.fileSize && old.modified == entry.modified) {
+                next.push_back(old);
+                ++stats.reused;
+                continue;
+            }
+        }
+        pending.push_back(next.size());
+        next.push_back(std::move(entry));
+    }
+    stats.files = next.size();
+    stats.removed = items.size() - stillPresent;
+
+    // Biggest files first so one huge file doesn't start last.
+    std::stable_sort(pending.begin(), pending.end(),
+        [&](size_t a, size_t b) { return next[a].fileSize > next[b].fileSize; });
+    {
+        dp::thread_pool<> pool(std::max(1u, threads));
+        std::vector<std::future<void>> done;
+        done.reserve(pending.size());
+        for (size_t i : pending) {
+            stats.bytesParsed += next[i].fileSize;
+            done.push_back(pool.enqueue([&base, &next, i]() {
+                IndexEntry& slot = next[i];
+                IndexEntry summary = summarize(base / fromUtf8(slot.path));
+                summary.path = std::move(slot.path);
+                summary.fileSize = slot.fileSize;
+                summary.modified = slot.modified;
+                slot = std::move(summary);
+            }));
+        }
+        for (auto& task : done)
+            task.get();
+    }
+    stats.parsed = pending.size();
+    for (size_t i : pending) {
+        if (!next[i].ok)
+            ++stats.failed;
+    }
+
+    std::sort(next.begin(), next.end(), [](const IndexEntry& a, const IndexEntry& b) { return a.path < b.path; });
+    items = std::move(next);
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return stats;
+}
+
+bool LibraryIndex::load(const fs::path& indexFile) {
+    items.clear();
+    std::ifstream in(indexFile, std::ios::binary);
+    if (!in)
+        return false;
+    IndexReader reader(in);
+    char magic[8] = {};
+    uint32_t version = 0;
+    uint32_t count = 0;
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, INDEX_MAGIC, sizeof(magic)) != 0 ||
+        !reader.get(version) || version != INDEX_VERSION || !reader.get(count))
+        return false;
+
+    std::vector<IndexEntry> loaded;
+    loaded.reserve(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        IndexEntry e;
+        uint8_t ok = 0;
+        bool good = reader.getString(e.path) && reader.get(e.fileSize) && reader.get(e.modified) && reader.get(ok);
+        if (good && ok) {
+            e.ok = true;
+            good = reader.get(e.format) && reader.get(e.division) && reader.get(e.tracks) && reader.get(e.channels) &&
+                reader.get(e.notes) && reader.get(e.lowestNote) && reader.get(e.highestNote) &&
+                reader.get(e.timeSigNumerator) && reader.get(e.timeSigDenominator) &&
+                reader.get(e.tempoChanges) && reader.get(e.initialBpm) && reader.get(e.seconds);
+        }
+        else if (good) {
+            good = reader.getString(e.error);
+        }
+        if (!good)
+            return false;
+        loaded.push_back(std::move(e));
+    }
+    items = std::move(loaded);
+    return true;
+}
+
+bool LibraryIndex::save(const fs::path& indexFile) const {
+    fs::path temp = indexFile;
+    temp += ".tmp";
+    std::error_code ec;
+    {
+        std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+        if (!out)
+            return false;
+        IndexWriter writer(out);
+        out.write(INDEX_MAGIC, sizeof(INDEX_MAGIC));
+        writer.put(INDEX_VERSION);
+        writer.put(static_cast<uint32_t>(items.size()));
+        for (const auto& e : items) {
+            writer.putString(e.path);
+            writer.put(e.fileSize);
+            writer.put(e.modified);
+            writer.put(static_cast<uint8_t>(e.ok ? 1 : 0));
+            if (!e.ok) {
+                writer.putString(e.error);
+                continue;
+            }
+            writer.put(e.format);
+            writer.put(e.division);
+            writer.put(e.tracks);
+            writer.put(e.channels);
+            writer.put(e.notes);
+            writer.put(e.lowestNote);
+            writer.put(e.highestNote);
+            writer.put(e.timeSigNumerator);
+            writer.put(e.timeSigDenominator);
+            writer.put(e.tempoChanges);
+            writer.put(e.initialBpm);
+            writer.put(e.seconds);
+        }
+        if (!out.flush()) {
+            out.close();
+            fs::remove(temp, ec);
+            return false;
+        }
+    }
+    fs::rename(temp, indexFile, ec);
+    if (ec) {
+        fs::remove(temp, ec);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,59 @@
+#pragma once
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+// What the library browser needs to know about one MIDI file without loading it.
+struct IndexEntry {
+    std::string path;              // relative to the library root, '/'-separated UTF-8
+    uint64_t fileSize = 0;
+    int64_t modified = 0;          // last_write_time ticks; with fileSize, decides re-indexing
+    bool ok = false;               // false: the parser rejected the file, see `error`
+    std::string error;
+    uint16_t format = 0;
+    uint16_t division = 0;
+    uint16_t tracks = 0;           // tracks holding at least one event
+    uint16_t channels = 0;         // bit n set if MIDI channel n plays a note
+    uint32_t notes = 0;            // note-ons with velocity > 0
+    uint8_t lowestNote = 0;
+    uint8_t highestNote = 0;
+    uint8_t timeSigNumerator = 4;
+    uint8_t timeSigDenominator = 4;
+    uint32_t tempoChanges = 0;
+    double initialBpm = 120.0;
+    double seconds = 0.0;          // up to the last note event, like the player's song length
+};
+
+struct IndexStats {
+    size_t files = 0;              // MIDI files found under the root
+    size_t parsed = 0;             // new or changed, parsed this run
+    size_t reused = 0;             // unchanged, taken from the previous index
+    size_t failed = 0;             // parsed but rejected
+    size_t removed = 0;            // in the previous index, gone from disk
+    uint64_t bytesParsed = 0;
+    double seconds = 0.0;
+};
+
+// On-disk summary of a MIDI library. update() walks the tree and re-parses only
+// files whose size or modification time differ from the previous run.
+class LibraryIndex {
+public:
+    // False if the file is missing or not an index of this version; the index is then empty.
+    bool load(const std::filesystem::path& indexFile);
+    // Written through a temporary file and renamed over the old index.
+    [[nodiscard]] bool save(const std::filesystem::path& indexFile) const;
+
+    IndexStats update(const std::filesystem::path& root, unsigned threads, bool rebuild = false);
+
+    [[nodiscard]] const std::vector<IndexEntry>& entries() const noexcept { return items; }
+
+    // Parses one file and reduces it to its summary in a single pass over the events.
+    [[nodiscard]] static IndexEntry summarize(const std::filesystem::path& file);
+
+private:
+    std::vector<IndexEntry> items;   // sorted by path
+};
@@ -0,0 +1,81 @@
+// MIDIIndexer - headless batch indexer for a MIDI library.
+//
+//   MIDIIndexer <library-dir> [-o <index-file>] [-j <threads>] [--rebuild] [--list]
+//
+// The index defaults to <library-dir>/.midipp_index. Files whose size and
+// modification time match the previous index are not parsed again.
+#include "LibraryIndex.hpp"
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+
+namespace {
+    int usage() {
+        std::cerr << "usage: MIDIIndexer <library-dir> [-o <index-file>] [-j <threads>] [--rebuild] [--list]\n";
+        return 2;
+    }
+}
+
+int main(int argc, char** argv) {
+    std::filesystem::path root;
+    std::filesystem::path indexFile;
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    bool rebuild = false;
+    bool list = false;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "-o" && i + 1 < argc)
+            indexFile = argv[++i];
+        else if (arg == "-j" && i + 1 < argc)
+            threads = static_cast<unsigned>(std::max(1, std::atoi(argv[++i])));
+        else if (arg == "--rebuild")
+            rebuild = true;
+        else if (arg == "--list")
+            list = true;
+        else if (!arg.empty() && arg[0] != '-' && root.empty())
+            root = arg;
+        else
+            return usage();
+    }
+    if (root.empty())
+        return usage();
+    std::error_code ec;
+    if (!std::filesystem::is_directory(root, ec)) {
+        std::cerr << "[Index] Not a directory: " << root.string() << "\n";
+        return 1;
+    }
+    if (indexFile.empty())
+        indexFile = root / ".midipp_index";
+
+    LibraryIndex index;
+    if (!rebuild && !index.load(indexFile) && std::filesystem::exists(indexFile, ec))
+        std::cout << "[Index] Ignoring unreadable index " << indexFile.string() << "\n";
+
+    const IndexStats stats = index.update(root, threads, rebuild);
+    std::cout << "[Index] " << stats.files << " files: " << stats.parsed << " parsed, "
+        << stats.reused << " unchanged, " << stats.failed << " failed, " << stats.removed << " removed\n";
+    std::cout << "[Index] " << std::fixed << std::setprecision(1) << stats.seconds * 1000.0 << " ms, "
+        << stats.bytesParsed / (1024.0 * 1024.0) << " MB parsed on " << threads
+        << (threads == 1 ? " thread" : " threads") << "\n";
+
+    if (list) {
+        for (const auto& e : index.entries()) {
+            std::cout << e.path << '\t';
+            if (!e.ok) {
+                std::cout << "error\t" << e.error << "\n";
+                continue;
+            }
+            std::cout << std::setprecision(1) << e.seconds << "s\t" << e.notes << " notes\t"
+                << e.tracks << " tracks\t" << e.initialBpm << " bpm\n";
+        }
+    }
+
+    if (!index.save(indexFile)) {
+        std::cerr << "[Index] Could not write " << indexFile.string() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,242 @@
+// ScheduleCacheTest - write/map round trip of schedule_cache files.
+//
+// A schedule written with one key must map back record for record, with the
+// same tables, and only under that key: any other content or settings hash,
+// and any truncated or damaged file, has to be turned away so the player
+// falls back to process_tracks. Exits non-zero on the first failed check.
+#include "ScheduleCache.hpp"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+    int failures = 0;
+
+    void check(bool ok, const char* what) {
+        if (!ok) {
+            ++failures;
+            std::printf("FAIL %s\n", what);
+        }
+    }
+
+    std::vector<char> readAll(const fs::path& path) {
+        std::ifstream in(path, std::ios::binary);
+        return std::vector<char>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    void writeAll(const fs::path& path, const std::vector<char>& bytes) {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    }
+
+    // A schedule shaped like the player's: notes, pedal entries, a duplicate
+    // press and the track-less releases that close the song.
+    std::vector<schedule_cache::Record> sampleRecords() {
+        using schedule_cache::NO_TRACK;
+        using schedule_cache::SUSTAIN_NOTE;
+        std::vector<schedule_cache::Record> records;
+        for (int i = 0; i < 5000; ++i) {
+            const int64_t time = int64_t(i) * 1'234'567;
+            const auto track = static_cast<uint16_t>(i % 17);
+            const auto note = static_cast<uint8_t>(21 + i % 88);
+            records.push_back({ time, track, NO_TRACK, note, 0, static_cast<uint8_t>(1 + i % 127), 0 });
+            if (i % 7 == 0)
+                records.push_back({ time, track, static_cast<uint16_t>((i + 1) % 17), note, 0, 90, 0 });
+            if (i % 50 == 0)
+                records.push_back({ time, track, NO_TRACK, SUSTAIN_NOTE, static_cast<uint8_t>(i % 100 ? 0 : 1), 0,
+                    static_cast<uint8_t>(i % 128) });
+            records.push_back({ time + 600'000, track, NO_TRACK, note, 1, 0, 0 });
+        }
+        records.push_back({ INT64_MAX / 2, NO_TRACK, NO_TRACK, 60, 1, 0, 0 });
+        return records;
+    }
+
+    schedule_cache::ScheduleInfo sampleInfo() {
+        schedule_cache::ScheduleInfo info;
+        info.endNs = 6'172'835'000'000;
+        info.tempoChanges = { { 0.0, 500000.0 }, { 1920.0, 428571.0 }, { 76800.5, 600000.0 } };
+        info.timeSignatures = { { 0, 4, 4, 24, 8 }, { 3840, 3, 8, 36, 8 } };
+        info.drumFlags = { false, false, true, false, false, false, false, false, false,
+                           true, false, false, false, false, false, false, false };
+        info.tracks.resize(info.drumFlags.size(), { {}, -1 });
+        info.tracks[2].channelNoteOns[9] = 1840;
+        info.tracks[4].channelNoteOns[0] = 912;
+        info.tracks[4].channelNoteOns[3] = 17;
+        info.tracks[4].program = 48;
+        return info;
+    }
+
+    bool sameRecords(std::span<const schedule_cache::Record> a, const std::vector<schedule_cache::Record>& b) {
+        return a.size() == b.size() && (a.empty() || std::memcmp(a.data(), b.data(), a.size_bytes()) == 0);
+    }
+
+    bool sameInfo(const schedule_cache::ScheduleInfo& a, const schedule_cache::ScheduleInfo& b) {
+        if (a.endNs != b.endNs || a.tempoChanges != b.tempoChanges || a.drumFlags != b.drumFlags ||
+            a.tracks != b.tracks || a.timeSignatures.size() != b.timeSignatures.size())
+            return false;
+        for (size_t i = 0; i < a.timeSignatures.size(); ++i) {
+            const auto& x = a.timeSignatures[i];
+            const auto& y = b.timeSignatures[i];
+            if (x.tick != y.tick || x.numerator != y.numerator || x.denominator != y.denominator ||
+                x.clocksPerClick != y.clocksPerClick || x.thirtySecondNotesPerQuarter != y.thirtySecondNotesPerQuarter)
+                return false;
+        }
+        return true;
+    }
+
+    bool opens(const fs::path& path, const schedule_cache::Key& key) {
+        schedule_cache::View view;
+        return view.open(path, key);
+    }
+
+    void roundTrip(const fs::path& dir) {
+        const schedule_cache::Key key{ 0x1122334455667788ull, 0x0102030405060708ull };
+        const fs::path midi = dir / "song.mid";
+        const fs::path path = schedule_cache::pathFor(midi, key);
+        check(path.parent_path() == dir / ".midipp_cache", "cache files live in .midipp_cache next to the song");
+        check(schedule_cache::pathFor(midi, { key.content, key.settings + 1 }) != path,
+            "another settings hash names another file");
+
+        const auto records = sampleRecords();
+        const auto info = sampleInfo();
+        check(schedule_cache::write(path, key, records, info), "write succeeds and creates the folder");
+        fs::path temp = path;
+        temp += ".tmp";
+        check(!fs::exists(temp), "write leaves no temporary file behind");
+
+        {
+            schedule_cache::View view;
+            check(view.open(path, key), "the file maps back under its own key");
+            check(sameRecords(view.records(), records), "records map back unchanged");
+            schedule_cache::ScheduleInfo back;
+            back.drumFlags = { true };   // stale contents are replaced
+            view.readInfo(back);
+            check(sameInfo(back, info), "tempo, time signatures, track summaries, drum flags and end time read back");
+        }
+
+        // The settings key is what keeps a schedule built with other options from being reused.
+        check(!opens(path, { key.content, key.settings ^ 1 }), "another settings hash is rejected");
+        check(!opens(path, { key.content ^ 1, key.settings }), "another content hash is rejected");
+        check(!opens(dir / ".midipp_cache" / "missing.sched", key), "a missing file is rejected");
+
+        // Rewriting in place (as after a settings change) replaces the old file.
+        std::vector<schedule_cache::Record> shorter(records.begin(), records.begin() + 100);
+        schedule_cache::ScheduleInfo plain;
+        check(schedule_cache::write(path, key, shorter, plain), "rewrite over an existing file succeeds");
+        {
+            schedule_cache::View view;
+            check(view.open(path, key) && sameRecords(view.records(), shorter), "the rewritten file maps back");
+            schedule_cache::ScheduleInfo back = info;
+            view.readInfo(back);
+            check(sameInfo(back, plain), "empty tables read back empty");
+        }
+        check(schedule_cache::write(path, key, records, info), "restore the full file");
+
+        // Damaged files: the size check and header fields catch each of these.
+        const std::vector<char> good = readAll(path);
+        const fs::path damaged = dir / "damaged.sched";
+        auto damagedOpens = [&](std::vector<char> bytes) {
+            writeAll(damaged, bytes);
+            return opens(damaged, key);
+        };
+        check(damagedOpens(good), "an intact copy opens");
+        check(!damagedOpens(std::vector<char>(good.begin(), good.end() - 1)), "a truncated file is rejected");
+        check(!damagedOpens(std::vector<char>(good.begin(), good.begin() + 63)), "a torn header is rejected");
+        {
+            auto bytes = good;
+            bytes.push_back(0);
+            check(!damagedOpens(bytes), "trailing bytes are rejected");
+        }
+        {
+            auto bytes = good;
+            bytes[0] ^= 0x20;
+            check(!damagedOpens(bytes), "a bad magic is rejected");
+        }
+        {
+            auto bytes = good;
+            bytes[8] = static_cast<char>(schedule_cache::FORMAT_VERSION + 1);   // version, little-endian
+            check(!damagedOpens(bytes), "another format version is rejected");
+        }
+        {
+            auto bytes = good;
+            bytes[12] = static_cast<char>(sizeof(schedule_cache::Record) + 8);   // record size
+            check(!damagedOpens(bytes), "another record size is rejected");
+        }
+        check(!damagedOpens({}), "an empty file is rejected");
+
+        const schedule_cache::Key emptyKey{ 7, 9 };
+        const fs::path emptyPath = schedule_cache::pathFor(midi, emptyKey);
+        check(schedule_cache::write(emptyPath, emptyKey, {}, {}), "an empty schedule writes");
+        {
+            schedule_cache::View view;
+            check(view.open(emptyPath, emptyKey) && view.records().empty(), "an empty schedule maps back");
+        }
+    }
+
+    void trackPacking() {
+        const int tracks[] = { -1, 0, 1, 16, 255, 256, 0xFFFE };
+        for (const int track : tracks) {
+            check(schedule_cache::unpackTrack(schedule_cache::packTrack(track)) == track,
+                ("track " + std::to_string(track) + " survives packing").c_str());
+        }
+        check(schedule_cache::packTrack(-1) == schedule_cache::NO_TRACK, "no track packs as NO_TRACK");
+    }
+
+    void hashing(const fs::path& dir) {
+        const fs::path path = dir / "hash.bin";
+        // Every tail length past the 32-byte lanes, and a change in each byte.
+        for (size_t size = 1; size <= 72; ++size) {
+            std::vector<char> bytes(size);
+            for (size_t i = 0; i < size; ++i)
+                bytes[i] = static_cast<char>(i * 31 + size);
+            writeAll(path, bytes);
+            uint64_t first = 0, second = 0;
+            check(schedule_cache::hashFile(path, first) && schedule_cache::hashFile(path, second) && first == second,
+                "hashing the same file twice agrees");
+            for (size_t i = 0; i < size; ++i) {
+                auto changed = bytes;
+                changed[i] ^= 1;
+                writeAll(path, changed);
+                uint64_t other = 0;
+                if (!schedule_cache::hashFile(path, other) || other == first) {
+                    check(false, ("a one-byte change alters the hash (size " + std::to_string(size) + ")").c_str());
+                    break;
+                }
+            }
+            bytes.push_back(0);
+            writeAll(path, bytes);
+            uint64_t longer = 0;
+            check(schedule_cache::hashFile(path, longer) && longer != first, "an appended zero alters the hash");
+        }
+        uint64_t unused = 0;
+        check(!schedule_cache::hashFile(dir / "missing.mid", unused), "a missing file has no hash");
+
+        check(schedule_cache::combine(1, 2) != schedule_cache::combine(1, 3), "combine depends on the value");
+        check(schedule_cache::combine(schedule_cache::combine(0, 1), 0) !=
+              schedule_cache::combine(schedule_cache::combine(0, 0), 1), "combine depends on the order");
+    }
+}
+
+int main() {
+    std::error_code ec;
+    const fs::path dir = fs::temp_directory_path() / ("midipp_cache_test_" + std::to_string(
+        static_cast<unsigned long long>(std::chrono::steady_clock::now().time_since_epoch().count())));
+    fs::create_directories(dir, ec);
+    if (ec) {
+        std::printf("FAIL cannot create %s\n", dir.string().c_str());
+        return 1;
+    }
+    roundTrip(dir);
+    trackPacking();
+    hashing(dir);
+    fs::remove_all(dir, ec);
+    std::printf("%d failures\n", failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,228 @@
+// VectorScanTest - the vector scans in decodeTrack against the scalar decoder.
+//
+// Every crafted track is decoded with the scalar loop, the narrow (SSE2) scan and,
+// where the CPU has AVX2, the wide scan. Events, the error and its offset must be
+// identical. Exits non-zero on the first divergence.
+#include "midi_parser.h"
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+    using Bytes = std::vector<uint8_t>;
+
+    void appendVarLen(Bytes& out, uint32_t value) {
+        uint8_t groups[5];
+        int count = 0;
+        do {
+            groups[count++] = static_cast<uint8_t>(value & 0x7F);
+            value >>= 7;
+        } while (value);
+        while (count > 1)
+            out.push_back(groups[--count] | 0x80);
+        out.push_back(groups[0]);
+    }
+
+    void appendEndOfTrack(Bytes& out) {
+        out.insert(out.end(), { 0x00, 0xFF, 0x2F, 0x00 });
+    }
+
+    bool sameEvents(const MidiEventStore& a, const MidiEventStore& b) {
+        if (a.size() != b.size() || a.payloadCount() != b.payloadCount())
+            return false;
+        for (size_t e = 0; e < a.size(); ++e) {
+            if (a.tick(e) != b.tick(e) || a.status(e) != b.status(e) ||
+                a.data1(e) != b.data1(e) || a.data2(e) != b.data2(e))
+                return false;
+        }
+        return true;
+    }
+
+    struct Runner {
+        bool wide = MidiParser::wideScanAvailable();
+        size_t tracks = 0;
+        size_t failures = 0;
+
+        void check(const std::string& name, const Bytes& track) {
+            ++tracks;
+            const char* data = reinterpret_cast<const char*>(track.data());
+            MidiTrack scalar;
+            const DecodeStatus expected = MidiParser::decodeTrackPayload(data, track.size(),
+                MidiParser::ScanPath::Scalar, scalar);
+
+            const MidiParser::ScanPath paths[] = { MidiParser::ScanPath::Narrow, MidiParser::ScanPath::Wide };
+            for (const auto path : paths) {
+                if (path == MidiParser::ScanPath::Wide && !wide)
+                    continue;
+                MidiTrack scanned;
+                const DecodeStatus status = MidiParser::decodeTrackPayload(data, track.size(), path, scanned);
+                if (status.error == expected.error && status.offset == expected.offset &&
+                    sameEvents(scanned.events, scalar.events))
+                    continue;
+                if (++failures <= 10) {
+                    std::printf("FAIL %s (%s): scalar %s at %u, %zu events; scan %s at %u, %zu events\n",
+                        name.c_str(), path == MidiParser::ScanPath::Wide ? "AVX2" : "SSE2",
+                        describeDecodeError(expected.error), expected.offset, scalar.events.size(),
+                        describeDecodeError(status.error), status.offset, scanned.events.size());
+                }
+            }
+        }
+    };
+
+    // Running-status runs of every length around the 8/16/32-byte block edges, at
+    // every alignment, for both strides, ending cleanly and cut short.
+    void runningStatusRuns(Runner& runner) {
+        const uint8_t statuses[] = { 0x90, 0x80, 0xB0, 0xE0, 0xC0, 0xD0 };
+        for (const uint8_t status : statuses) {
+            const bool twoByte = (status & 0xF0) == 0xC0 || (status & 0xF0) == 0xD0;
+            for (int padding = 0; padding < 4; ++padding) {
+                for (int count = 0; count <= 72; ++count) {
+                    Bytes track;
+                    track.reserve(16 + 4 * padding + 3 * count);
+                    for (int i = 0; i < padding; ++i)
+                        track.insert(track.end(), { 0x00, 0xFF, 0x01, 0x00 });   // empty text events
+                    track.insert(track.end(), { 0x00, status, 0x3C });
+                    if (!twoByte)
+                        track.push_back(0x40);
+                    for (int i = 0; i < count; ++i) {
+                        track.push_back(static_cast<uint8_t>((i * 37) % 128));
+                        track.push_back(static_cast<uint8_t>((i * 11) % 128));
+                        if (!twoByte)
+                            track.push_back(static_cast<uint8_t>(i % 128));
+                    }
+                    const std::string name = "run " + std::to_string(status) + " x" + std::to_string(count) +
+                        " +" + std::to_string(padding);
+                    Bytes ended = track;
+                    appendEndOfTrack(ended);
+                    runner.check(name, ended);
+                    if (track.size() > 1) {
+                        track.pop_back();
+                        runner.check(name + " truncated", track);
+                    }
+                }
+            }
+        }
+    }
+
+    // Explicit-status runs broken by a multi-byte delta, a one-data-byte message or meta.
+    void explicitStatusRuns(Runner& runner) {
+        for (int count = 0; count <= 40; ++count) {
+            for (int breaker = 0; breaker < 3; ++breaker) {
+                Bytes track;
+                for (int i = 0; i < count; ++i) {
+                    track.push_back(static_cast<uint8_t>(i % 128));
+                    track.push_back(static_cast<uint8_t>(i % 2 ? 0x90 : 0x80 | (i % 16)));
+                    track.push_back(static_cast<uint8_t>(i % 128));
+                    track.push_back(0x64);
+                }
+                if (breaker == 0)
+                    track.insert(track.end(), { 0x81, 0x00, 0x90, 0x3C, 0x40 });
+                else if (breaker == 1)
+                    track.insert(track.end(), { 0x00, 0xC3, 0x05, 0x10, 0x06 });
+                else
+                    track.insert(track.end(), { 0x00, 0xFF, 0x51, 0x03, 0x07, 0xA1, 0x20 });
+                for (int i = 0; i < count; ++i)
+                    track.insert(track.end(), { 0x01, 0x91, 0x30, 0x20 });
+                appendEndOfTrack(track);
+                runner.check("explicit x" + std::to_string(count) + " breaker " + std::to_string(breaker), track);
+            }
+        }
+    }
+
+    // Runs that start just short of UINT32_MAX ticks: the scalar decoder reports
+    // TickOverflow at the event that wraps, and so must the scans.
+    void tickOverflow(Runner& runner) {
+        const uint8_t statuses[] = { 0xC0, 0x90 };
+        for (const uint8_t status : statuses) {
+            const bool twoByte = status == 0xC0;
+            for (uint32_t headroom = 0; headroom <= 2200; headroom += (headroom < 64 ? 1 : 7)) {
+                Bytes track;
+                uint32_t remaining = UINT32_MAX - headroom;
+                while (remaining > 0) {
+                    const uint32_t delta = std::min<uint32_t>(remaining, 0x0FFFFFFF);
+                    appendVarLen(track, delta);
+                    track.insert(track.end(), { 0xB0, 0x07, 0x64 });
+                    remaining -= delta;
+                }
+                track.insert(track.end(), { 0x00, status, 0x05 });
+                if (!twoByte)
+                    track.push_back(0x40);
+                // Zero deltas first, so the scan is running (not backed off) when the ticks climb.
+                for (int i = 0; i < 96; ++i) {
+                    track.push_back(i < 48 ? 0x00 : 0x7F);
+                    track.push_back(0x05);
+                    if (!twoByte)
+                        track.push_back(0x40);
+                }
+                appendEndOfTrack(track);
+                runner.check("overflow " + std::to_string(status) + " headroom " + std::to_string(headroom), track);
+            }
+        }
+    }
+
+    // Random mixes of everything the decoder handles, then the same tracks with
+    // bytes flipped and cut off to exercise the error paths.
+    void randomTracks(Runner& runner) {
+        std::mt19937 rng(20240611u);
+        auto below = [&](uint32_t n) { return static_cast<uint32_t>(rng() % n); };
+        for (int t = 0; t < 3000; ++t) {
+            Bytes track;
+            uint8_t lastStatus = 0;
+            const int events = 1 + static_cast<int>(below(300));
+            for (int e = 0; e < events; ++e) {
+                const uint32_t roll = below(100);
+                appendVarLen(track, roll < 80 ? below(128) : roll < 95 ? below(16384) : below(1u << 21));
+                const uint32_t kind = below(100);
+                if (kind < 85) {
+                    static const uint8_t kinds[] = { 0x80, 0x90, 0xA0, 0xB0, 0xC0, 0xD0, 0xE0 };
+                    const uint8_t status = static_cast<uint8_t>(kinds[below(7)] | below(16));
+                    const bool running = status == lastStatus || (lastStatus && below(100) < 60);
+                    const uint8_t used = running ? lastStatus : status;
+                    if (!running)
+                        track.push_back(used);
+                    lastStatus = used;
+                    track.push_back(static_cast<uint8_t>(below(128)));
+                    if ((used & 0xF0) != 0xC0 && (used & 0xF0) != 0xD0)
+                        track.push_back(static_cast<uint8_t>(below(128)));
+                }
+                else if (kind < 95) {
+                    track.insert(track.end(), { 0xFF, static_cast<uint8_t>(below(128)) });
+                    const uint32_t length = below(12);
+                    appendVarLen(track, length);
+                    for (uint32_t i = 0; i < length; ++i)
+                        track.push_back(static_cast<uint8_t>(rng()));
+                    lastStatus = 0xFF;
+                }
+                else {
+                    track.push_back(0xF0);
+                    const uint32_t length = below(8);
+                    appendVarLen(track, length);
+                    for (uint32_t i = 0; i < length; ++i)
+                        track.push_back(static_cast<uint8_t>(below(128)));
+                    lastStatus = 0xF0;
+                }
+            }
+            appendEndOfTrack(track);
+            runner.check("random " + std::to_string(t), track);
+
+            Bytes corrupt = track;
+            for (uint32_t flips = 1 + below(4); flips > 0; --flips)
+                corrupt[below(static_cast<uint32_t>(corrupt.size()))] = static_cast<uint8_t>(rng());
+            corrupt.resize(1 + below(static_cast<uint32_t>(corrupt.size())));
+            runner.check("random " + std::to_string(t) + " corrupt", corrupt);
+        }
+    }
+}
+
+int main() {
+    Runner runner;
+    runningStatusRuns(runner);
+    explicitStatusRuns(runner);
+    tickOverflow(runner);
+    randomTracks(runner);
+    std::printf("%zu tracks, %s, %zu failures\n", runner.tracks,
+        runner.wide ? "scalar/SSE2/AVX2" : "scalar/SSE2 (no AVX2 on this CPU)", runner.failures);
+    return runner.failures == 0 ? 0 : 1;
+}